@@ -0,0 +1,113 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AstArena.h"
+
+#include "misc.h"
+
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+AstArena::SizeClass AstArena::sClasses[AstArena::kNumClasses];
+size_t              AstArena::sBytesReserved = 0;
+size_t              AstArena::sBytesInUse    = 0;
+int                 AstArena::sEnabled       = -1;
+
+// The arena has no locking.  AST nodes are only created and deleted on the
+// main thread; e.g. the --parallel-parse threads only read files.
+static std::thread::id sOwner = std::this_thread::get_id();
+
+void* AstArena::allocate(size_t size) {
+  void* retval = NULL;
+
+  if (size > kMaxSize || isEnabled() == false) {
+    retval = ::operator new(size);
+
+  } else {
+    size_t     index = (size + kGranularity - 1) / kGranularity;
+    SizeClass& cls   = sClasses[index];
+
+    INT_ASSERT(std::this_thread::get_id() == sOwner);
+
+    if (cls.freeList != NULL) {
+      retval       = cls.freeList;
+      cls.freeList = cls.freeList->next;
+
+    } else {
+      if (cls.next == cls.end) {
+        newSlab(index);
+      }
+
+      retval   = cls.next;
+      cls.next = cls.next + index * kGranularity;
+    }
+
+    sBytesInUse = sBytesInUse + index * kGranularity;
+  }
+
+  return retval;
+}
+
+// 'size' is the size of the dynamic type; BaseAST has a virtual destructor
+void AstArena::release(void* ptr, size_t size) {
+  if (size > kMaxSize || isEnabled() == false) {
+    ::operator delete(ptr);
+
+  } else {
+    size_t     index = (size + kGranularity - 1) / kGranularity;
+    SizeClass& cls   = sClasses[index];
+    FreeNode*  node  = static_cast<FreeNode*>(ptr);
+
+    INT_ASSERT(std::this_thread::get_id() == sOwner);
+
+    node->next   = cls.freeList;
+    cls.freeList = node;
+
+    sBytesInUse  = sBytesInUse - index * kGranularity;
+  }
+}
+
+size_t AstArena::bytesReserved() {
+  return sBytesReserved;
+}
+
+size_t AstArena::bytesInUse() {
+  return sBytesInUse;
+}
+
+bool AstArena::isEnabled() {
+  if (sEnabled < 0) {
+    sEnabled = (getenv("CHPL_DISABLE_AST_ARENA") == NULL) ? 1 : 0;
+  }
+
+  return sEnabled == 1;
+}
+
+void AstArena::newSlab(size_t index) {
+  size_t     nodeSize = index * kGranularity;
+  size_t     numNodes = kSlabSize / nodeSize;
+  char*      slab     = static_cast<char*>(::operator new(numNodes * nodeSize));
+  SizeClass& cls      = sClasses[index];
+
+  cls.next       = slab;
+  cls.end        = slab + numNodes * nodeSize;
+
+  sBytesReserved = sBytesReserved + numNodes * nodeSize;
+}
@@ -19,6 +19,7 @@
 
 #include "baseAST.h"
 
+#include "AstArena.h"
 #include "astutil.h"
 #include "CForLoop.h"
 #include "CatchStmt.h"
@@ -163,6 +164,14 @@ void printStatistics(const char* pass) {
   last_nasts = nasts;
 }
 
+void* BaseAST::operator new(size_t size) {
+  return AstArena::allocate(size);
+}
+
+void BaseAST::operator delete(void* ptr, size_t size) {
+  AstArena::release(ptr, size);
+}
+
 /* Certain AST elements, such as PRIM_END_OF_STATEMENT, should just
    be adjusted when variables are removed. */
 static void remove_weak_links(VarSymbol* var) {
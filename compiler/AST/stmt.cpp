@@ -26,6 +26,7 @@
 #include "passes.h"
 #include "stlUtil.h"
 #include "stringutil.h"
+#include "visibleFunctions.h"
 
 #include "AstVisitor.h"
 
@@ -465,6 +466,8 @@ BlockStmt::useListAdd(UseStmt* use) {
   }
 
   useList->insertAtTail(use);
+
+  visibleFunctionsInvalidateUses();
 }
 
 
@@ -481,6 +484,8 @@ BlockStmt::useListRemove(ModuleSymbol* mod) {
           if (curMod == mod) {
             symExpr->remove();
 
+            visibleFunctionsInvalidateUses();
+
             retval = true;
             break;
           }
@@ -506,6 +511,8 @@ BlockStmt::useListClear() {
     }
 
     useList = NULL;
+
+    visibleFunctionsInvalidateUses();
   }
 }
 
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Microbenchmark comparing FlatHashMap with Map and Vec sets.
+//
+// Build and run from $CHPL_HOME/compiler with
+//
+//   make hash-map-bench
+//
+// Keys model AST nodes: distinct objects hashed by a small integer id.
+//
+
+#include "flatHashMap.h"
+#include "map.h"
+#include "vec.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+
+struct BenchKey {
+  int id;
+};
+
+template<>
+uintptr_t _vec_hasher(BenchKey* key) {
+  return (key != NULL) ? (uintptr_t) key->id : 0;
+}
+
+// vec.o and map.o report internal errors through these
+void gdbShouldBreakHere() {
+}
+
+void setupError(const char* subdir, const char* filename, int lineno, int tag) {
+  fprintf(stderr, "error at %s/%s:%d\n", subdir, filename, lineno);
+}
+
+void handleError(const char* fmt, ...) {
+  va_list args;
+
+  va_start(args, fmt);
+  vfprintf(stderr, fmt, args);
+  va_end(args);
+
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+static double now() {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// Lookups are repeated so that small tables run long enough to time
+static const long kLookupsPerSize = 20000000;
+
+static void report(const char* what, int size, long ops, double secs) {
+  printf("  %-24s %9d keys %8.1f Mops/s\n", what, size, ops / secs / 1e6);
+}
+
+static void benchMap(BenchKey* keys, BenchKey* missing, int n) {
+  Map<BenchKey*, int> map;
+  long                rounds = kLookupsPerSize / n;
+  long                found  = 0;
+  double              start  = now();
+
+  for (int i = 0; i < n; i++) {
+    map.put(&keys[i], i + 1);
+  }
+
+  report("Map::put", n, n, now() - start);
+
+  start = now();
+
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < n; i++) {
+      found += map.get(&keys[i]) != 0;
+    }
+  }
+
+  report("Map::get (hit)", n, rounds * n, now() - start);
+
+  start = now();
+
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < n; i++) {
+      found += map.get(&missing[i]) != 0;
+    }
+  }
+
+  report("Map::get (miss)", n, rounds * n, now() - start);
+
+  if (found != rounds * n) {
+    printf("Map: unexpected number of hits %ld\n", found);
+  }
+}
+
+static void benchVec(BenchKey* keys, BenchKey* missing, int n) {
+  Vec<BenchKey*> set;
+  long           rounds = kLookupsPerSize / n;
+  long           found  = 0;
+  double         start  = now();
+
+  for (int i = 0; i < n; i++) {
+    set.set_add(&keys[i]);
+  }
+
+  report("Vec::set_add", n, n, now() - start);
+
+  start = now();
+
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < n; i++) {
+      found += set.set_in(&keys[i]) != NULL;
+    }
+  }
+
+  report("Vec::set_in (hit)", n, rounds * n, now() - start);
+
+  start = now();
+
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < n; i++) {
+      found += set.set_in(&missing[i]) != NULL;
+    }
+  }
+
+  report("Vec::set_in (miss)", n, rounds * n, now() - start);
+
+  if (found != rounds * n) {
+    printf("Vec: unexpected number of hits %ld\n", found);
+  }
+}
+
+static void benchFlatHashMap(BenchKey* keys, BenchKey* missing, int n) {
+  FlatHashMap<BenchKey*, int> map;
+  long                        rounds = kLookupsPerSize / n;
+  long                        found  = 0;
+  double                      start  = now();
+
+  for (int i = 0; i < n; i++) {
+    map.put(&keys[i], i + 1);
+  }
+
+  report("FlatHashMap::put", n, n, now() - start);
+
+  start = now();
+
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < n; i++) {
+      found += map.get(&keys[i]) != 0;
+    }
+  }
+
+  report("FlatHashMap::get (hit)", n, rounds * n, now() - start);
+
+  start = now();
+
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < n; i++) {
+      found += map.get(&missing[i]) != 0;
+    }
+  }
+
+  report("FlatHashMap::get (miss)", n, rounds * n, now() - start);
+
+  if (found != rounds * n) {
+    printf("FlatHashMap: unexpected number of hits %ld\n", found);
+  }
+
+  for (int i = 0; i < n; i += 2) {
+    map.del(&keys[i]);
+  }
+
+  for (int i = 0; i < n; i++) {
+    if ((map.get(&keys[i]) != 0) != (i % 2 == 1)) {
+      printf("FlatHashMap: del() lost key %d\n", i);
+      break;
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  int sizes[] = { 16, 256, 4096, 65536, 1048576 };
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    int       n       = sizes[s];
+    BenchKey* keys    = new BenchKey[n];
+    BenchKey* missing = new BenchKey[n];
+
+    // AST ids are dense and mostly increasing
+    for (int i = 0; i < n; i++) {
+      keys[i].id    = i + 1;
+      missing[i].id = n + i + 1;
+    }
+
+    printf("%d keys\n", n);
+
+    benchMap(keys, missing, n);
+    benchVec(keys, missing, n);
+    benchFlatHashMap(keys, missing, n);
+
+    delete [] keys;
+    delete [] missing;
+  }
+
+  return 0;
+}
@@ -20,6 +20,7 @@
 #include "codegen.h"
 
 #include "astutil.h"
+#include "buildCache.h"
 #include "chplmath.h"
 #include "clangBuiltinsWrappedSet.h"
 #include "clangUtil.h"
@@ -34,6 +35,7 @@
 #include "LayeredValueTable.h"
 #include "mli.h"
 #include "mysystem.h"
+#include "objectCache.h"
 #include "passes.h"
 #include "stlUtil.h"
 #include "stmt.h"
@@ -1377,7 +1379,7 @@ static void codegen_defn(std::set<const char*> & cnames, std::vector<TypeSymbol*
   genComment("Virtual Method Table");
   genVirtualMethodTable(types, false);
 
-  if(fIncrementalCompilation) {
+  if(codegenSeparateModules()) {
     genComment("Global Variables");
     forv_Vec(VarSymbol, varSymbol, globals) {
       varSymbol->codegenGlobalDef(false);
@@ -1905,6 +1907,93 @@ static void codegen_header_addons() {
   }
 }
 
+/************************************* | **************************************
+*                                                                             *
+* --codegen-shards with the C backend: instead of #including every module     *
+* into _main.c, each module is compiled against chpl__header.h as in          *
+* --incremental, and the module files are grouped into shard files            *
+* chpl__shard<i>.c that the generated Makefile compiles in parallel.          *
+* Grouping the modules, rather than compiling each on its own, keeps the      *
+* number of times the C compiler parses the (large) header close to the       *
+* number of jobs that can run.  (The LLVM backend splits its module in        *
+* clangUtil.cpp instead.)                                                     *
+*                                                                             *
+************************************** | *************************************/
+
+// The objects built from separately compiled module code
+static std::vector<const char*> sSeparateObjects;
+
+struct ShardedModule {
+  const char* filename;
+  long        size;
+};
+
+static bool shardCCode() {
+  return fCodegenShards > 0 && llvmCodegen == false;
+}
+
+bool codegenSeparateModules() {
+  return fIncrementalCompilation || shardCCode();
+}
+
+// With an object cache, --incremental compiles the internal and standard
+// modules separately too, so that their objects can be reused
+static bool isSeparateModule(ModuleSymbol* mod) {
+  return shardCCode() ||
+         (fIncrementalCompilation &&
+          (mod->modTag == MOD_USER || objectCacheEnabled()));
+}
+
+static int numCodegenShards() {
+  return std::min(fCodegenShards, allModules.n);
+}
+
+static const char* shardFileName(int shard) {
+  return astr("chpl__shard", istr(shard));
+}
+
+static bool isLargerModule(const ShardedModule& a, const ShardedModule& b) {
+  return a.size > b.size;
+}
+
+//
+// Assign the largest remaining module to the least loaded shard, using the
+// size of the generated C code as an estimate of the time to compile it.
+//
+static void codegen_shards(std::vector<ShardedModule>& modules) {
+  int                                   numShards = numCodegenShards();
+  std::vector<long>                     load(numShards, 0);
+  std::vector<std::vector<const char*> > members(numShards);
+
+  std::stable_sort(modules.begin(), modules.end(), isLargerModule);
+
+  for (size_t i = 0; i < modules.size(); i++) {
+    int lightest = 0;
+
+    for (int j = 1; j < numShards; j++) {
+      if (load[j] < load[lightest])
+        lightest = j;
+    }
+
+    load[lightest] += modules[i].size;
+    members[lightest].push_back(modules[i].filename);
+  }
+
+  for (int i = 0; i < numShards; i++) {
+    fileinfo shardfile;
+
+    openCFile(&shardfile, shardFileName(i), "c");
+
+    fprintf(shardfile.fptr, "#include \"chpl__header.h\"\n");
+
+    for (size_t j = 0; j < members[i].size(); j++) {
+      fprintf(shardfile.fptr, "#include \"%s\"\n", members[i][j]);
+    }
+
+    closeCFile(&shardfile, false);
+  }
+}
+
 static void
 codegen_config() {
   GenInfo* info = gGenInfo;
@@ -2337,12 +2426,16 @@ void codegen() {
     fprintf(mainfile.fptr, "#include \"chpl__defn.c\"\n");
 
     std::vector<const char*> userFileName;
-    if(fIncrementalCompilation) {
+    if(shardCCode()) {
+      for (int i = 0; i < numCodegenShards(); i++) {
+        userFileName.push_back(genIntermediateFilename(shardFileName(i)));
+      }
+    } else if(fIncrementalCompilation) {
       ChainHashMap<char*, StringHashFns, int> fileNameHashMap;
       forv_Vec(ModuleSymbol, currentModule, allModules) {
         const char* filename = NULL;
         filename = generateFileName(fileNameHashMap, filename, currentModule->name);
-        if(currentModule->modTag == MOD_USER) {
+        if(isSeparateModule(currentModule)) {
           fileinfo modulefile;
           openCFile(&modulefile, filename, "c");
           int modulePathLen = strlen(astr(modulefile.pathname));
@@ -2356,6 +2449,8 @@ void codegen() {
     }
     
     codegen_makefile(&mainfile, NULL, false, userFileName);
+
+    sSeparateObjects = userFileName;
   }
 
   if (fLibraryCompile && fLibraryMakefile) {
@@ -2396,6 +2491,8 @@ void codegen() {
 #endif
   } else {
     ChainHashMap<char*, StringHashFns, int> fileNameHashMap;
+    std::vector<ShardedModule>              shardedModules;
+
     forv_Vec(ModuleSymbol, currentModule, allModules) {
       const char* filename = NULL;
       filename = generateFileName(fileNameHashMap, filename,currentModule->name);
@@ -2403,16 +2500,25 @@ void codegen() {
       fileinfo modulefile;
       openCFile(&modulefile, filename, "c");
       info->cfile = modulefile.fptr;
-      if(fIncrementalCompilation && (currentModule->modTag == MOD_USER))
+      if(isSeparateModule(currentModule))
         fprintf(modulefile.fptr, "#include \"chpl__header.h\"\n");
       currentModule->codegenDef();
 
+      if(shardCCode()) {
+        ShardedModule sm = { modulefile.filename, ftell(modulefile.fptr) };
+
+        shardedModules.push_back(sm);
+      }
+
       closeCFile(&modulefile);
 
-      if(!(fIncrementalCompilation && (currentModule->modTag == MOD_USER)))
+      if(!isSeparateModule(currentModule))
         fprintf(mainfile.fptr, "#include \"%s%s\"\n", filename, ".c");
     }
 
+    if(shardCCode())
+      codegen_shards(shardedModules);
+
     if (fMultiLocaleInterop) {
       codegenMultiLocaleInteropWrappers();
     }
@@ -2449,15 +2555,29 @@ void makeBinary(void) {
 #endif
   } else {
     const char* makeflags = printSystemCommands ? "-f " : "-s -f ";
+    const char* makejobs  = "";
+
+    // One job per shard plus one for _main.c
+    if (fCodegenShards > 0)
+      makejobs = astr("-j", istr(numCodegenShards() + 1), " ");
+
     const char* command = astr(astr(CHPL_MAKE, " "),
+                               makejobs,
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
+
+    objectCacheRestore(sSeparateObjects);
+
     mysystem(command, "compiling generated source");
+
+    objectCacheStore();
   }
 
   if (fLibraryCompile && fLibraryPython) {
     codegen_make_python_module();
   }
+
+  buildCacheStore();
 }
 
 GenInfo::GenInfo()
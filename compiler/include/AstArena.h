@@ -0,0 +1,84 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _AST_ARENA_H_
+#define _AST_ARENA_H_
+
+#include <cstddef>
+
+/************************************* | **************************************
+*                                                                             *
+* Storage for AST nodes.                                                      *
+*                                                                             *
+* BaseAST overrides operator new/delete to allocate from this arena.  Nodes   *
+* are grouped into size classes, which in practice gives each node type its   *
+* own slabs.  A new node is carved from the current slab of its class, and a  *
+* node deleted by cleanAst() is pushed on a free list that is reused by the   *
+* next allocation of the same class.  Slabs are not returned to the system.   *
+*                                                                             *
+* This keeps nodes of one type close together in memory and makes the        *
+* thousands of deletes that follow every pass inexpensive.                    *
+*                                                                             *
+* The arena is not thread safe: it asserts that it is only used by the       *
+* thread that started the compiler.                                           *
+*                                                                             *
+* The arena does not track which pass allocated a node.  cleanAst() finds     *
+* the dead nodes by scanning the g*s vectors, which the passes iterate over   *
+* directly and which must be compacted anyway, so sweeping the slabs by       *
+* generation instead would not save that scan.                                *
+*                                                                             *
+* Setting CHPL_DISABLE_AST_ARENA in the environment reverts to the global     *
+* allocator, e.g. when hunting for use-after-free errors with valgrind.       *
+*                                                                             *
+************************************** | *************************************/
+
+class AstArena {
+public:
+  static void*  allocate(size_t size);
+  static void   release (void* ptr, size_t size);
+
+  static size_t bytesReserved();
+  static size_t bytesInUse();
+
+private:
+  static bool   isEnabled();
+  static void   newSlab(size_t index);
+
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  struct SizeClass {
+    FreeNode* freeList;
+    char*     next;
+    char*     end;
+  };
+
+  static const size_t kGranularity = 16;
+  static const size_t kMaxSize     = 1024;
+  static const size_t kSlabSize    = 64 * 1024;
+  static const size_t kNumClasses  = kMaxSize / kGranularity + 1;
+
+  static SizeClass    sClasses[kNumClasses];
+  static size_t       sBytesReserved;
+  static size_t       sBytesInUse;
+  static int          sEnabled;
+};
+
+#endif
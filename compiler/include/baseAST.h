@@ -284,6 +284,10 @@ public:
 
   static  const       std::string tabText;
 
+  // AST nodes are allocated from the AstArena
+  static void*        operator new   (size_t size);
+  static void         operator delete(void* ptr, size_t size);
+
 protected:
                     BaseAST(AstTag type);
   virtual          ~BaseAST();
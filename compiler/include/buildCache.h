@@ -0,0 +1,47 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BUILD_CACHE_H_
+#define _BUILD_CACHE_H_
+
+#include <cstdio>
+
+extern char fBuildCacheDir[FILENAME_MAX+1];
+
+/************************************* | **************************************
+*                                                                             *
+* The build cache (--build-cache <dir>) is a content-addressed store of the   *
+* executables produced by previous compilations.  Its key is formed from     *
+*                                                                             *
+*   - the compiler version and the full compilation command                   *
+*   - the CHPL_* environment                                                  *
+*   - the contents of every parsed module, including the internal and        *
+*     standard modules, and of the C sources/headers named on the command    *
+*     line or in 'require' statements                                         *
+*   - the runtime library that the executable would be linked against        *
+*                                                                             *
+* The key is computed once parsing is complete.  If an executable is found   *
+* for it, that executable is installed and the remaining passes are skipped. *
+*                                                                             *
+************************************** | *************************************/
+
+bool buildCacheLookup();
+void buildCacheStore();
+
+#endif
@@ -147,6 +147,10 @@ void setupClang(GenInfo* info, std::string rtmain);
 
 bool isBuiltinExternCFunction(const char* cname);
 
+// True if some module code is compiled separately from _main.c, in which
+// case symbols shared through chpl__header.h cannot be static
+bool codegenSeparateModules();
+
 std::string numToString(int64_t num);
 std::string int64_to_string(int64_t i);
 std::string uint64_to_string(uint64_t i);
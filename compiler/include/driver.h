@@ -70,6 +70,7 @@ extern bool fNoOptimizeOnClauses;
 extern bool fNoRemoveEmptyRecords;
 extern bool fNoInferLocalFields;
 extern bool fRemoveUnreachableBlocks;
+extern bool fNoVisibleFunctionCache;
 extern bool fReplaceArrayAccessesWithRefTemps;
 extern int  optimize_on_clause_limit;
 extern int  scalar_replace_limit;
@@ -126,6 +127,7 @@ extern const char* CHPL_LLVM_UNIQ_CFG_PATH;
 
 extern bool  printPasses;
 extern FILE* printPassesFile;
+extern FILE* printPassMemoryFile;
 
 extern char fExplainCall[256];
 extern int  explainCallID;
@@ -136,6 +138,7 @@ extern char fExplainInstantiation[256];
 /// resolution.
 extern bool fExplainVerbose;
 extern bool fParseOnly;
+extern bool fParallelParse;
 extern bool fPrintAllCandidates;
 extern bool fPrintCallGraph;
 extern bool fPrintCallStackOnError;
@@ -239,6 +242,9 @@ extern bool fMinimalModules;
 // Set to true if we want to enable incremental compilation.
 extern bool fIncrementalCompilation;
 
+// Number of translation units for the generated module code, 0 for one
+extern int  fCodegenShards;
+
 // LLVM flags (-mllvm)
 extern std::string llvmFlags;
 
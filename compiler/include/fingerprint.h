@@ -0,0 +1,60 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _FINGERPRINT_H_
+#define _FINGERPRINT_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+/************************************* | **************************************
+*                                                                             *
+* A Fingerprint accumulates a 128-bit content hash over strings, integers,    *
+* and file contents.  It is used to form the keys of on-disk caches, where    *
+* two inputs with the same fingerprint are assumed to produce the same        *
+* output.                                                                     *
+*                                                                             *
+* Every item added is prefixed with its length so that, for example, adding  *
+* "ab" then "c" differs from adding "a" then "bc".                            *
+*                                                                             *
+************************************** | *************************************/
+
+class Fingerprint {
+public:
+                 Fingerprint();
+
+  void           add(const char* str);
+  void           add(const std::string& str);
+  void           add(uint64_t value);
+  void           add(const void* data, size_t len);
+
+  // Adds the contents of the file, or returns false if it cannot be read
+  bool           addFile(const char* path);
+
+  std::string    toString()                                            const;
+
+private:
+  void           addBytes(const void* data, size_t len);
+
+  uint64_t       mHash1;
+  uint64_t       mHash2;
+};
+
+#endif
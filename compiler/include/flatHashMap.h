@@ -0,0 +1,342 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _FLAT_HASH_MAP_H_
+#define _FLAT_HASH_MAP_H_
+
+#include "vec.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+/************************************* | **************************************
+*                                                                             *
+* FlatHashMap<K, V> is an open-addressing hash map that uses Robin Hood       *
+* probing with backward-shift deletion.                                       *
+*                                                                             *
+* It is intended as a drop-in replacement for Map<K, V> in lookup-heavy       *
+* code.  As with Map                                                          *
+*                                                                             *
+*   - keys are hashed with _vec_hasher() and compared with ==                 *
+*   - the key (K) 0 is reserved and must not be inserted                      *
+*   - get() returns (V) 0 for a missing key and put() replaces the value of   *
+*     an existing key                                                         *
+*                                                                             *
+* Unlike Map, whose Vec-based sets give up after SET_MAX_PROBE probes and     *
+* then grow, a lookup here examines a short run of adjacent slots and stops  *
+* as soon as the probe distance exceeds that of the slot being examined.     *
+* Keys and values are stored in one flat array and the probe distances in a  *
+* separate byte array, so a miss usually touches a single cache line.        *
+*                                                                             *
+************************************** | *************************************/
+
+template <class K, class V>
+class FlatHashMap {
+public:
+                 FlatHashMap();
+                ~FlatHashMap();
+
+  V              get(K key)                                          const;
+  V*             getRef(K key);
+  bool           contains(K key)                                     const;
+
+  void           put(K key, V value);
+  bool           del(K key);
+
+  void           clear();
+
+  int            size()                                              const;
+
+  void           get_keys  (Vec<K>& keys)                            const;
+  void           get_values(Vec<V>& values)                          const;
+
+  // Iterate with: for (int i = 0; i < map.capacity(); i++)
+  //                 if (map.isFull(i)) ... map.keyAt(i) ... map.valueAt(i)
+  int            capacity()                                          const;
+  bool           isFull(int slot)                                    const;
+  K              keyAt(int slot)                                     const;
+  V&             valueAt(int slot);
+
+private:
+                 FlatHashMap(const FlatHashMap& other);
+  FlatHashMap&   operator=  (const FlatHashMap& other);
+
+  struct Slot {
+    K            key;
+    V            value;
+  };
+
+  // A slot's distance is 0 if it is empty and 1 + probe length otherwise
+  static const int      kMaxDistance = 255;
+
+  int            findSlot(K key)                                     const;
+  uint32_t       homeSlot(K key)                                     const;
+  void           grow();
+  void           insert(K key, V value);
+
+  Slot*          mSlots;
+  uint8_t*       mDistances;
+  uint32_t       mMask;
+  int            mCount;
+};
+
+/************************************* | **************************************
+*                                                                             *
+* Implementation                                                              *
+*                                                                             *
+************************************** | *************************************/
+
+template <class K, class V>
+inline FlatHashMap<K, V>::FlatHashMap() {
+  mSlots     = NULL;
+  mDistances = NULL;
+  mMask      = 0;
+  mCount     = 0;
+}
+
+template <class K, class V>
+inline FlatHashMap<K, V>::~FlatHashMap() {
+  delete [] mSlots;
+  delete [] mDistances;
+}
+
+template <class K, class V>
+inline V FlatHashMap<K, V>::get(K key) const {
+  int slot = findSlot(key);
+
+  return (slot >= 0) ? mSlots[slot].value : (V) 0;
+}
+
+template <class K, class V>
+inline V* FlatHashMap<K, V>::getRef(K key) {
+  int slot = findSlot(key);
+
+  return (slot >= 0) ? &mSlots[slot].value : NULL;
+}
+
+template <class K, class V>
+inline bool FlatHashMap<K, V>::contains(K key) const {
+  return findSlot(key) >= 0;
+}
+
+template <class K, class V>
+inline void FlatHashMap<K, V>::put(K key, V value) {
+  if (V* existing = getRef(key)) {
+    *existing = value;
+
+  } else {
+    // Keep the load factor at or below 7/8
+    if (mSlots == NULL || (uint32_t) (mCount + 1) * 8 > (mMask + 1) * 7) {
+      grow();
+    }
+
+    insert(key, value);
+
+    mCount = mCount + 1;
+  }
+}
+
+template <class K, class V>
+inline bool FlatHashMap<K, V>::del(K key) {
+  int  slot   = findSlot(key);
+  bool retval = false;
+
+  if (slot >= 0) {
+    uint32_t i    = slot;
+    uint32_t next = (i + 1) & mMask;
+
+    // Shift the following run back by one, closing the gap
+    while (mDistances[next] > 1) {
+      mSlots[i]     = mSlots[next];
+      mDistances[i] = mDistances[next] - 1;
+
+      i             = next;
+      next          = (next + 1) & mMask;
+    }
+
+    mSlots[i].key   = (K) 0;
+    mSlots[i].value = (V) 0;
+    mDistances[i]   = 0;
+
+    mCount          = mCount - 1;
+    retval          = true;
+  }
+
+  return retval;
+}
+
+template <class K, class V>
+inline void FlatHashMap<K, V>::clear() {
+  delete [] mSlots;
+  delete [] mDistances;
+
+  mSlots     = NULL;
+  mDistances = NULL;
+  mMask      = 0;
+  mCount     = 0;
+}
+
+template <class K, class V>
+inline int FlatHashMap<K, V>::size() const {
+  return mCount;
+}
+
+template <class K, class V>
+inline void FlatHashMap<K, V>::get_keys(Vec<K>& keys) const {
+  for (int i = 0; i < capacity(); i++) {
+    if (isFull(i) == true) {
+      keys.add(mSlots[i].key);
+    }
+  }
+}
+
+template <class K, class V>
+inline void FlatHashMap<K, V>::get_values(Vec<V>& values) const {
+  for (int i = 0; i < capacity(); i++) {
+    if (isFull(i) == true) {
+      values.add(mSlots[i].value);
+    }
+  }
+}
+
+template <class K, class V>
+inline int FlatHashMap<K, V>::capacity() const {
+  return (mSlots != NULL) ? (int) mMask + 1 : 0;
+}
+
+template <class K, class V>
+inline bool FlatHashMap<K, V>::isFull(int slot) const {
+  return mDistances[slot] != 0;
+}
+
+template <class K, class V>
+inline K FlatHashMap<K, V>::keyAt(int slot) const {
+  return mSlots[slot].key;
+}
+
+template <class K, class V>
+inline V& FlatHashMap<K, V>::valueAt(int slot) {
+  return mSlots[slot].value;
+}
+
+template <class K, class V>
+inline int FlatHashMap<K, V>::findSlot(K key) const {
+  int retval = -1;
+
+  if (mSlots != NULL) {
+    uint32_t i        = homeSlot(key);
+    int      distance = 1;
+
+    // Robin Hood invariant: a key is never further from home than the
+    // occupant of a slot it probes, so stop once we pass that distance.
+    while (distance <= mDistances[i]) {
+      if (mSlots[i].key == key) {
+        retval = (int) i;
+        break;
+      }
+
+      i        = (i + 1) & mMask;
+      distance = distance + 1;
+    }
+  }
+
+  return retval;
+}
+
+// _vec_hasher() returns ids for AST nodes and already-mixed values for
+// strings.  Ids are dense, so keeping them close to the identity keeps
+// consecutive nodes in neighbouring slots; folding in the high bits stops
+// sparse values from piling up on the same low bits.
+template <class K, class V>
+inline uint32_t FlatHashMap<K, V>::homeSlot(K key) const {
+  uint64_t h = (uint64_t) _vec_hasher(key);
+
+  h = h ^ (h >> 16) ^ (h >> 32);
+
+  return (uint32_t) h & mMask;
+}
+
+template <class K, class V>
+void FlatHashMap<K, V>::grow() {
+  Slot*    oldSlots     = mSlots;
+  uint8_t* oldDistances = mDistances;
+  uint32_t oldCapacity  = (oldSlots != NULL) ? mMask + 1 : 0;
+  uint32_t newCapacity  = (oldCapacity == 0) ? 16 : oldCapacity * 2;
+
+  mSlots     = new Slot[newCapacity];
+  mDistances = new uint8_t[newCapacity];
+  mMask      = newCapacity - 1;
+
+  for (uint32_t i = 0; i < newCapacity; i++) {
+    mSlots[i].key   = (K) 0;
+    mSlots[i].value = (V) 0;
+  }
+
+  memset(mDistances, 0, newCapacity);
+
+  for (uint32_t i = 0; i < oldCapacity; i++) {
+    if (oldDistances[i] != 0) {
+      insert(oldSlots[i].key, oldSlots[i].value);
+    }
+  }
+
+  delete [] oldSlots;
+  delete [] oldDistances;
+}
+
+template <class K, class V>
+void FlatHashMap<K, V>::insert(K key, V value) {
+  uint32_t i        = homeSlot(key);
+  int      distance = 1;
+
+  while (mDistances[i] != 0) {
+    if (mDistances[i] < distance) {
+      // Take the slot from the richer occupant and continue with it
+      Slot displaced         = mSlots[i];
+      int  displacedDistance = mDistances[i];
+
+      mSlots[i].key   = key;
+      mSlots[i].value = value;
+      mDistances[i]   = (uint8_t) distance;
+
+      key             = displaced.key;
+      value           = displaced.value;
+      distance        = displacedDistance;
+    }
+
+    i        = (i + 1) & mMask;
+    distance = distance + 1;
+
+    // A run this long means heavy clustering.  Grow the table, which
+    // rehashes everything else, and start over with the key in hand.
+    if (distance > kMaxDistance) {
+      grow();
+
+      i        = homeSlot(key);
+      distance = 1;
+    }
+  }
+
+  mSlots[i].key   = key;
+  mSlots[i].value = value;
+  mDistances[i]   = (uint8_t) distance;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OBJECT_CACHE_H_
+#define _OBJECT_CACHE_H_
+
+#include <cstdio>
+#include <vector>
+
+extern char fObjectCacheDir[FILENAME_MAX+1];
+
+/************************************* | **************************************
+*                                                                             *
+* The object cache (--object-cache <dir>) stores the object files built from  *
+* the separately compiled module code of --incremental and --codegen-shards.  *
+* An object is keyed by                                                       *
+*                                                                             *
+*   - the compiler version, the compiler and the runtime library              *
+*   - the CHPL_* environment and the flags passed to the C compiler           *
+*   - the contents of the generated .c file and of the generated files it    *
+*     #includes, notably chpl__header.h                                       *
+*                                                                             *
+* Before the generated Makefile is run, objects found in the cache are        *
+* copied into the intermediate directory; since they are newer than their     *
+* .c files, make does not rebuild them.  Objects that make does build are     *
+* added to the cache afterwards.                                              *
+*                                                                             *
+************************************** | *************************************/
+
+bool objectCacheEnabled();
+
+// 'objects' are the object files named in the Makefile's CHPLUSEROBJ
+void objectCacheRestore(const std::vector<const char*>& objects);
+void objectCacheStore();
+
+#endif
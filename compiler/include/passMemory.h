@@ -0,0 +1,44 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PASS_MEMORY_H_
+#define _PASS_MEMORY_H_
+
+//
+// Support for --print-pass-memory <filename>
+//
+// After every pass one JSON object is appended to the file, on a line of
+// its own, recording
+//
+//   - the resident set size of the compiler and its growth during the pass
+//   - the number of live AST nodes of each AstTag
+//   - the number of nodes reclaimed by cleanAst() at the end of the pass
+//   - the space reserved for, and in use by, the AstArena
+//   - the functions and modules that hold the most AST nodes
+//
+// The file is flushed after every record so that the report for a
+// compilation that runs out of memory is complete up to the failing pass.
+//
+
+void passMemoryStart();
+void passMemoryBeforeCleanAst();
+void passMemoryEndOfPass(const char* passName);
+void passMemoryStop();
+
+#endif
@@ -38,6 +38,8 @@ void       getVisibleFunctions(const char*      name,
 BlockStmt* getVisibilityScope(Expr* expr);
 BlockStmt* getInstantiationPoint(Expr* expr);
 
+void       visibleFunctionsInvalidateUses();
+
 void       visibleFunctionsClear();
 
 #endif
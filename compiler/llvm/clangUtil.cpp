@@ -55,6 +55,7 @@
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/MC/SubtargetFeature.h"
@@ -66,6 +67,7 @@
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 
 #ifdef HAVE_LLVM_RV
 #include "rv/passes.h"
@@ -2607,6 +2609,8 @@ static void runLLVMLinking(std::string useLinkCXX, std::string options,
 static std::string getLibraryOutputPath();
 static void moveGeneratedLibraryFile(const char* tmpbinname);
 static void moveResultFromTmp(const char* resultName, const char* tmpbinname);
+static void emitSplitObjectFiles(llvm::raw_fd_ostream&    moduleOfile,
+                                 std::vector<std::string>& splitObjFiles);
 
 void makeBinaryLLVM(void) {
 
@@ -2811,9 +2815,15 @@ void makeBinaryLLVM(void) {
         == llvm::Reloc::Model::PIC_);
   }
 
+  // The extra objects when code generation is split (--codegen-shards)
+  std::vector<std::string> splitObjFiles;
+
   // Emit the .o file for linking with clang
   // Setup and run LLVM passes to emit a .o file to outputOfile
-  {
+  if (fCodegenShards > 1) {
+    emitSplitObjectFiles(outputOfile, splitObjFiles);
+    outputOfile.close();
+  } else {
     llvm::legacy::PassManager emitPM;
 
     emitPM.add(createTargetTransformInfoWrapperPass(
@@ -2935,7 +2945,7 @@ void makeBinaryLLVM(void) {
     useLinkCXX = ldOverride[0];
 
 
-  std::vector<std::string> dotOFiles;
+  std::vector<std::string> dotOFiles = splitObjFiles;
 
   // Gather C flags for compiling C files.
   std::string cargs;
@@ -3254,6 +3264,76 @@ static void runLLVMLinking(std::string useLinkCXX, std::string options,
   mysystem(command.c_str(), "Make Binary - Linking");
 }
 
+//
+// --codegen-shards: the optimized module is split into partitions whose
+// machine code is generated concurrently, each on its own thread with its
+// own LLVMContext and TargetMachine.  This happens after the module-level
+// optimizations, and in particular after the GlobalToWide passes for
+// --llvm-wide-opt, so the partitions no longer contain wide pointers and
+// whole-program inlining is unaffected.
+//
+// The first partition is written to 'moduleOfile' (chpl__module.o) and the
+// others to chpl__module<i>.o, which are returned in 'splitObjFiles'.
+//
+static void emitSplitObjectFiles(llvm::raw_fd_ostream&    moduleOfile,
+                                 std::vector<std::string>& splitObjFiles) {
+  GenInfo*                                            info = gGenInfo;
+  llvm::TargetMachine*                                tm   = info->targetMachine;
+  std::vector<std::unique_ptr<llvm::raw_fd_ostream> > ofiles;
+  std::vector<llvm::raw_pwrite_stream*>               streams;
+
+  streams.push_back(&moduleOfile);
+
+  for (int i = 1; i < fCodegenShards; i++) {
+    const char*     filename = genIntermediateFilename(astr("chpl__module",
+                                                            istr(i),
+                                                            ".o"));
+    std::error_code error;
+
+    ofiles.emplace_back(new llvm::raw_fd_ostream(filename,
+                                                 error,
+                                                 llvm::sys::fs::F_None));
+
+    if (error || ofiles.back()->has_error())
+      USR_FATAL("Could not open output file %s", filename);
+
+    streams.push_back(ofiles.back().get());
+    splitObjFiles.push_back(filename);
+  }
+
+  // Each thread needs a TargetMachine configured like the main one
+  auto tmFactory = [tm]() {
+    return std::unique_ptr<llvm::TargetMachine>(
+             tm->getTarget().createTargetMachine(tm->getTargetTriple().str(),
+                                                 tm->getTargetCPU(),
+                                                 tm->getTargetFeatureString(),
+                                                 tm->Options,
+                                                 tm->getRelocationModel(),
+                                                 tm->getCodeModel(),
+                                                 tm->getOptLevel()));
+  };
+
+  // splitCodeGen() consumes its module, but info->module belongs to clang
+#if HAVE_LLVM_VER >= 70
+  std::unique_ptr<llvm::Module> copy = llvm::CloneModule(*info->module);
+#else
+  std::unique_ptr<llvm::Module> copy = llvm::CloneModule(info->module);
+#endif
+
+  llvm::splitCodeGen(std::move(copy),
+                     streams,
+                     {},
+                     tmFactory,
+                     llvm::TargetMachine::CGFT_ObjectFile);
+
+  for (size_t i = 0; i < ofiles.size(); i++) {
+    ofiles[i]->close();
+
+    if (ofiles[i]->has_error())
+      USR_FATAL("Could not write output file %s", splitObjFiles[i].c_str());
+  }
+}
+
 static std::string getLibraryOutputPath() {
   // Need to reuse some of the stuff in codegen_makefile.  It doesn't save the
   // full filename that is used when in library mode, so we don't have an
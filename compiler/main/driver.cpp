@@ -25,6 +25,7 @@
 #include "driver.h"
 
 #include "arg.h"
+#include "buildCache.h"
 #include "chpl.h"
 #include "commonFlags.h"
 #include "config.h"
@@ -36,6 +37,7 @@
 #include "ModuleSymbol.h"
 #include "misc.h"
 #include "mysystem.h"
+#include "objectCache.h"
 #include "parser.h"
 #include "PhaseTracker.h"
 #include "primitive.h"
@@ -157,6 +159,7 @@ bool fEnableTaskTracking = false;
 
 bool  printPasses     = false;
 FILE* printPassesFile = NULL;
+FILE* printPassMemoryFile = NULL;
 
 // flag for llvmWideOpt
 bool fLLVMWideOpt = false;
@@ -179,7 +182,9 @@ bool fNoRemoveEmptyRecords = true;
 bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fIncrementalCompilation = false;
+int  fCodegenShards = 0;
 bool fNoOptimizeForallUnordered = false;
+bool fNoVisibleFunctionCache = false;
 
 int optimize_on_clause_limit = 20;
 int scalar_replace_limit = 8;
@@ -205,6 +210,7 @@ bool fDenormalize = true;
 char fExplainInstantiation[256] = "";
 bool fExplainVerbose = false;
 bool fParseOnly = false;
+bool fParallelParse = false;
 bool fPrintCallGraph = false;
 bool fPrintAllCandidates = false;
 bool fPrintCallStackOnError = false;
@@ -837,6 +843,14 @@ static void setPrintPassesFile(const ArgumentDescription* desc, const char* file
   }
 }
 
+static void setPrintPassMemoryFile(const ArgumentDescription* desc, const char* fileName) {
+  printPassMemoryFile = fopen(fileName, "w");
+
+  if (printPassMemoryFile == NULL) {
+    USR_WARN("Error opening printPassMemoryFile: %s.", fileName);
+  }
+}
+
 static void setLocal (const ArgumentDescription* desc, const char* unused) {
   // Used in postLocal() to set fLocal if user threw flag
   fUserSetLocal = true;
@@ -946,6 +960,7 @@ static ArgumentDescription arg_desc[] = {
 
  {"", ' ', NULL, "C Code Generation Options", NULL, NULL, NULL, NULL},
  {"codegen", ' ', NULL, "[Don't] Do code generation", "n", &no_codegen, "CHPL_NO_CODEGEN", NULL},
+ {"codegen-shards", ' ', "<n>", "Split generated code into <n> parts compiled in parallel, 0 for one", "I", &fCodegenShards, "CHPL_CODEGEN_SHARDS", NULL},
  {"cpp-lines", ' ', NULL, "[Don't] Generate #line annotations", "N", &printCppLineno, "CHPL_CG_CPP_LINES", noteCppLinesSet},
  {"max-c-ident-len", ' ', NULL, "Maximum length of identifiers in generated code, 0 for unlimited", "I", &fMaxCIdentLen, "CHPL_MAX_C_IDENT_LEN", NULL},
  {"munge-user-idents", ' ', NULL, "[Don't] Munge user identifiers to avoid naming conflicts with external code", "N", &fMungeUserIdents, "CHPL_MUNGE_USER_IDENTS"},
@@ -973,12 +988,15 @@ static ArgumentDescription arg_desc[] = {
  {"print-commands", ' ', NULL, "[Don't] print system commands", "N", &printSystemCommands, "CHPL_PRINT_COMMANDS", NULL},
  {"print-passes", ' ', NULL, "[Don't] print compiler passes", "N", &printPasses, "CHPL_PRINT_PASSES", NULL},
  {"print-passes-file", ' ', "<filename>", "Print compiler passes to <filename>", "S", NULL, "CHPL_PRINT_PASSES_FILE", setPrintPassesFile},
+ {"print-pass-memory", ' ', "<filename>", "Print memory use and AST node counts for each pass to <filename> as JSON", "S", NULL, "CHPL_PRINT_PASS_MEMORY", setPrintPassMemoryFile},
 
  {"", ' ', NULL, "Miscellaneous Options", NULL, NULL, NULL, NULL},
 // Support for extern { c-code-here } blocks could be toggled with this
 // flag, but instead we just leave it on if the compiler can do it.
 // {"extern-c", ' ', NULL, "Enable [disable] extern C block support", "f", &externC, "CHPL_EXTERN_C", NULL},
  DRIVER_ARG_DEVELOPER,
+ {"build-cache", ' ', "<directory>", "Reuse executables from previous identical compilations", "P", fBuildCacheDir, "CHPL_BUILD_CACHE", NULL},
+ {"object-cache", ' ', "<directory>", "Reuse object files for unchanged module code with --incremental or --codegen-shards", "P", fObjectCacheDir, "CHPL_OBJECT_CACHE", NULL},
  {"explain-call", ' ', "<call>[:<module>][:<line>]", "Explain resolution of call", "S256", fExplainCall, NULL, NULL},
  {"explain-instantiation", ' ', "<function|type>[:<module>][:<line>]", "Explain instantiation of type", "S256", fExplainInstantiation, NULL, NULL},
  {"explain-verbose", ' ', NULL, "Enable [disable] tracing of disambiguation with 'explain' options", "N", &fExplainVerbose, "CHPL_EXPLAIN_VERBOSE", NULL},
@@ -1096,6 +1114,7 @@ static ArgumentDescription arg_desc[] = {
  {"log-deleted-ids-to", ' ', "<filename>", "Log AST id and memory address of each deleted node to the specified file", "P", deletedIdFilename, "CHPL_DELETED_ID_FILENAME", NULL},
  {"memory-frees", ' ', NULL, "Enable [disable] memory frees in the generated code", "n", &fNoMemoryFrees, "CHPL_DISABLE_MEMORY_FREES", NULL},
  {"override-checking", ' ', NULL, "[Don't] check use of override keyword", "N", &fOverrideChecking, NULL, NULL},
+ {"parallel-parse", ' ', NULL, "[Don't] read module files on a thread pool while parsing", "N", &fParallelParse, "CHPL_PARALLEL_PARSE", NULL},
  {"prepend-internal-module-dir", ' ', "<directory>", "Prepend directory to internal module search path", "P", NULL, NULL, addInternalModulePath},
  {"prepend-standard-module-dir", ' ', "<directory>", "Prepend directory to standard module search path", "P", NULL, NULL, addStandardModulePath},
  {"preserve-inlined-line-numbers", ' ', NULL, "[Don't] Preserve file names/line numbers in inlined code", "N", &preserveInlinedLineNumbers, "CHPL_PRESERVE_INLINED_LINE_NUMBERS", NULL},
@@ -1103,6 +1122,7 @@ static ArgumentDescription arg_desc[] = {
  {"print-unused-internal-functions", ' ', NULL, "[Don't] print names and locations of unused internal functions", "N", &fPrintUnusedInternalFns, NULL, NULL},
  {"region-vectorizer", ' ', NULL, "Enable [disable] region vectorizer", "N", &fRegionVectorizer, NULL, NULL},
  {"remove-empty-records", ' ', NULL, "Enable [disable] empty record removal", "n", &fNoRemoveEmptyRecords, "CHPL_DISABLE_REMOVE_EMPTY_RECORDS", NULL},
+ {"visible-function-cache", ' ', NULL, "Enable [disable] memoizing visible function lookups during resolution", "n", &fNoVisibleFunctionCache, "CHPL_DISABLE_VISIBLE_FUNCTION_CACHE", NULL},
  {"remove-unreachable-blocks", ' ', NULL, "[Don't] remove unreachable blocks after resolution", "N", &fRemoveUnreachableBlocks, "CHPL_REMOVE_UNREACHABLE_BLOCKS", NULL},
  {"replace-array-accesses-with-ref-temps", ' ', NULL, "Enable [disable] replacing array accesses with reference temps (experimental)", "N", &fReplaceArrayAccessesWithRefTemps, NULL, NULL },
  {"incremental", ' ', NULL, "Enable [disable] using incremental compilation", "N", &fIncrementalCompilation, "CHPL_INCREMENTAL_COMP", NULL},
@@ -1444,6 +1464,29 @@ static void checkIncrementalAndOptimized() {
               " using -O optimizations directly.");
 }
 
+static void checkCodegenShards() {
+  if (fCodegenShards < 0) {
+    USR_FATAL("--codegen-shards must be 0 or more");
+  }
+
+  // The C backend's library Makefiles do not build separate objects
+  if (fCodegenShards > 0 && fLibraryCompile && !llvmCodegen) {
+    USR_WARN("--codegen-shards is not supported for libraries built with "
+             "the C backend; ignoring it");
+
+    fCodegenShards = 0;
+  }
+
+  // Like --incremental, sharding the C code makes functions non-static and
+  // keeps the C compiler from inlining across shards
+  std::size_t optimizationsEnabled = ccflags.find("-O");
+  if (fCodegenShards > 0 && !llvmCodegen &&
+      (optimizeCCode || optimizationsEnabled != std::string::npos))
+    USR_WARN("Compiling with --codegen-shards along with optimizations enabled"
+             " may lead to a slower execution time, since calls between"
+             " shards cannot be inlined.");
+}
+
 static void checkMLDebugAndLibmode(void) {
 
   if (!fMultiLocaleLibraryDebug) { return; }
@@ -1497,6 +1540,8 @@ static void postprocess_args() {
   checkTargetCpu();
 
   checkIncrementalAndOptimized();
+
+  checkCodegenShards();
 }
 
 int main(int argc, char* argv[]) {
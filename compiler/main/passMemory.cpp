@@ -0,0 +1,260 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "passMemory.h"
+
+#include "AstArena.h"
+#include "baseAST.h"
+#include "CatchStmt.h"
+#include "DecoratedClassType.h"
+#include "DeferStmt.h"
+#include "driver.h"
+#include "expr.h"
+#include "ForallStmt.h"
+#include "IfExpr.h"
+#include "LoopExpr.h"
+#include "stmt.h"
+#include "symbol.h"
+#include "TryStmt.h"
+#include "type.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+static const int kNumContributors = 10;
+
+typedef std::pair<int, BaseAST*> Contributor;
+
+static long sLastRssKB        = 0;
+static int  sNodesBeforeClean = 0;
+
+static long currentRssKB();
+static long peakRssKB();
+static int  countAstNodes();
+
+static void printContributors(const char*              key,
+                              std::map<BaseAST*, int>& counts);
+static void printJsonString(const char* str);
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+void passMemoryStart() {
+  if (printPassMemoryFile != NULL) {
+    sLastRssKB = currentRssKB();
+  }
+}
+
+void passMemoryBeforeCleanAst() {
+  if (printPassMemoryFile != NULL) {
+    sNodesBeforeClean = countAstNodes();
+  }
+}
+
+#define print_gvec_count(type)                                           \
+  fprintf(printPassMemoryFile, "%s\"%s\": %d",                           \
+          (sep++ == 0) ? "" : ", ", #type, g##type##s.n)
+
+#define count_gvec_contributors(type)                                    \
+  forv_Vec(type, ast, g##type##s) {                                      \
+    if (FnSymbol* fn = ast->getFunction())                               \
+      fnCounts[fn]++;                                                    \
+                                                                         \
+    if (ModuleSymbol* mod = ast->getModule())                            \
+      modCounts[mod]++;                                                  \
+  }
+
+void passMemoryEndOfPass(const char* passName) {
+  if (printPassMemoryFile != NULL) {
+    long                    rssKB     = currentRssKB();
+    int                     liveNodes = countAstNodes();
+    int                     freed     = 0;
+    int                     sep       = 0;
+    std::map<BaseAST*, int> fnCounts;
+    std::map<BaseAST*, int> modCounts;
+
+    // chpldoc runs do not clean the AST between passes
+    if (sNodesBeforeClean > liveNodes) {
+      freed = sNodesBeforeClean - liveNodes;
+    }
+
+    fprintf(printPassMemoryFile, "{\"pass\": ");
+    printJsonString(passName);
+    // ru_maxrss is sampled by the kernel and may lag the current RSS
+    fprintf(printPassMemoryFile,
+            ", \"rss_kb\": %ld, \"rss_growth_kb\": %ld, \"peak_rss_kb\": %ld",
+            rssKB,
+            rssKB - sLastRssKB,
+            std::max(rssKB, peakRssKB()));
+
+    fprintf(printPassMemoryFile,
+            ", \"ast_live\": %d, \"ast_freed\": %d",
+            liveNodes,
+            freed);
+
+    fprintf(printPassMemoryFile,
+            ", \"ast_arena_kb\": %lu, \"ast_arena_in_use_kb\": %lu",
+            (unsigned long) (AstArena::bytesReserved() / 1024),
+            (unsigned long) (AstArena::bytesInUse()    / 1024));
+
+    fprintf(printPassMemoryFile, ", \"ast_by_tag\": {");
+    foreach_ast(print_gvec_count);
+    fprintf(printPassMemoryFile, "}");
+
+    foreach_ast(count_gvec_contributors);
+
+    printContributors("top_functions", fnCounts);
+    printContributors("top_modules",   modCounts);
+
+    fprintf(printPassMemoryFile, "}\n");
+    fflush(printPassMemoryFile);
+
+    sLastRssKB        = rssKB;
+    sNodesBeforeClean = 0;
+  }
+}
+
+#undef print_gvec_count
+#undef count_gvec_contributors
+
+void passMemoryStop() {
+  if (printPassMemoryFile != NULL) {
+    fclose(printPassMemoryFile);
+
+    printPassMemoryFile = NULL;
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+// The current RSS is only available on Linux; fall back to the peak
+static long currentRssKB() {
+  long retval = 0;
+
+  if (FILE* fp = fopen("/proc/self/statm", "r")) {
+    long size     = 0;
+    long resident = 0;
+
+    if (fscanf(fp, "%ld %ld", &size, &resident) == 2) {
+      retval = resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    fclose(fp);
+  }
+
+  if (retval == 0) {
+    retval = peakRssKB();
+  }
+
+  return retval;
+}
+
+static long peakRssKB() {
+  struct rusage usage;
+  long          retval = 0;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    retval = usage.ru_maxrss / 1024;
+#else
+    retval = usage.ru_maxrss;
+#endif
+  }
+
+  return retval;
+}
+
+#define sum_gvecs(type) g##type##s.n
+
+static int countAstNodes() {
+  return foreach_ast_sep(sum_gvecs, +);
+}
+
+#undef sum_gvecs
+
+static bool largerContributor(const Contributor& a, const Contributor& b) {
+  return a.first  > b.first ||
+        (a.first == b.first && a.second->id < b.second->id);
+}
+
+static void printContributors(const char*              key,
+                              std::map<BaseAST*, int>& counts) {
+  std::vector<Contributor> sorted;
+
+  for (std::map<BaseAST*, int>::iterator it = counts.begin();
+       it != counts.end();
+       ++it) {
+    sorted.push_back(Contributor(it->second, it->first));
+  }
+
+  std::sort(sorted.begin(), sorted.end(), largerContributor);
+
+  fprintf(printPassMemoryFile, ", \"%s\": [", key);
+
+  for (size_t i = 0; i < sorted.size() && i < kNumContributors; i++) {
+    Symbol*       sym = toSymbol(sorted[i].second);
+    ModuleSymbol* mod = sym->getModule();
+
+    fprintf(printPassMemoryFile, "%s{\"name\": ", (i == 0) ? "" : ", ");
+    printJsonString(sym->name);
+
+    if (isFnSymbol(sym) == true && mod != NULL) {
+      fprintf(printPassMemoryFile, ", \"module\": ");
+      printJsonString(mod->name);
+    }
+
+    fprintf(printPassMemoryFile,
+            ", \"id\": %d, \"nodes\": %d}",
+            sym->id,
+            sorted[i].first);
+  }
+
+  fprintf(printPassMemoryFile, "]");
+}
+
+static void printJsonString(const char* str) {
+  fputc('"', printPassMemoryFile);
+
+  for (const char* c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      fprintf(printPassMemoryFile, "\\%c", *c);
+
+    } else if ((unsigned char) *c < 0x20) {
+      fprintf(printPassMemoryFile, "\\u%04x", (unsigned char) *c);
+
+    } else {
+      fputc(*c, printPassMemoryFile);
+    }
+  }
+
+  fputc('"', printPassMemoryFile);
+}
@@ -19,11 +19,13 @@
 
 #include "runpasses.h"
 
+#include "buildCache.h"
 #include "checks.h"
 #include "driver.h"
 #include "log.h"
 #include "parser.h"
 #include "passes.h"
+#include "passMemory.h"
 #include "PhaseTracker.h"
 
 #include <cstdio>
@@ -161,6 +163,8 @@ void runPasses(PhaseTracker& tracker, bool isChpldoc) {
 
   setupLogfiles();
 
+  passMemoryStart();
+
   if (printPasses == true || printPassesFile != 0) {
     tracker.ReportPass();
   }
@@ -186,8 +190,16 @@ void runPasses(PhaseTracker& tracker, bool isChpldoc) {
     if (isChpldoc == true && strcmp(sPassList[i].name, "docs") == 0) {
       break;
     }
+
+    // Break early if the build cache already holds this executable
+    if (isChpldoc == false && strcmp(sPassList[i].name, "parse") == 0 &&
+        buildCacheLookup() == true) {
+      break;
+    }
   }
 
+  passMemoryStop();
+
   destroyAst();
   teardownLogfiles();
 }
@@ -231,9 +243,12 @@ static void runPass(PhaseTracker& tracker, size_t passIndex, bool isChpldoc) {
   //
   if (!isChpldoc) {
     tracker.StartPhase(info->name, PhaseTracker::kCleanAst);
+    passMemoryBeforeCleanAst();
     cleanAst();
   }
 
+  passMemoryEndOfPass(info->name);
+
   if (printPasses == true || printPassesFile != 0) {
     tracker.ReportPass();
   }
@@ -33,7 +33,14 @@
 #include "symbol.h"
 #include "wellknown.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 BlockStmt*           yyblock                       = NULL;
 const char*          yyfilename                    = NULL;
@@ -60,9 +67,15 @@ static void          parseCommandLineFiles();
 
 static void          parseDependentModules(bool isInternal);
 
+static void          parseDependentModulesInWaves(bool isInternal);
+
 static ModuleSymbol* parseMod(const char* modName,
                               bool        isInternal);
 
+static const char*   modNameToPath(const char* modName,
+                                   bool        isInternal,
+                                   ModTag*     modTag);
+
 static ModuleSymbol* parseFile(const char* fileName,
                                ModTag      modTag,
                                bool        namedOnCommandLine);
@@ -74,6 +87,13 @@ static const char*   searchThePath(const char*      modName,
                                    bool             isInternal,
                                    Vec<const char*> searchPath);
 
+static void          startPrefetch(const std::vector<const char*>& paths);
+
+static void          finishPrefetch();
+
+static bool          takePrefetchedFile(const char*  path,
+                                        std::string& contents);
+
 /************************************* | **************************************
 *                                                                             *
 *                                                                             *
@@ -315,12 +335,30 @@ static void parseCommandLineFiles() {
     printModuleSearchPath();
   }
 
+  if (fParallelParse == true) {
+    std::vector<const char*> paths;
+
+    while ((inputFileName = nthFilename(fileNum++))) {
+      if (isChplSource(inputFileName)) {
+        paths.push_back(inputFileName);
+      }
+    }
+
+    startPrefetch(paths);
+
+    fileNum = 0;
+  }
+
   while ((inputFileName = nthFilename(fileNum++))) {
     if (isChplSource(inputFileName)) {
       parseFile(inputFileName, MOD_USER, true);
     }
   }
 
+  if (fParallelParse == true) {
+    finishPrefetch();
+  }
+
   if (fDocs == false || fDocsProcessUsedModules == true) {
     parseDependentModules(false);
 
@@ -456,10 +494,15 @@ static void ensureRequiredStandardModulesAreParsed() {
 ************************************** | *************************************/
 
 static void parseDependentModules(bool isInternal) {
-  forv_Vec(const char*, modName, sModNameList) {
-    if (sModDoneSet.set_in(modName)   == NULL &&
-        parseMod(modName, isInternal) != NULL) {
-      sModDoneSet.set_add(modName);
+  if (fParallelParse == true) {
+    parseDependentModulesInWaves(isInternal);
+
+  } else {
+    forv_Vec(const char*, modName, sModNameList) {
+      if (sModDoneSet.set_in(modName)   == NULL &&
+          parseMod(modName, isInternal) != NULL) {
+        sModDoneSet.set_add(modName);
+      }
     }
   }
 
@@ -472,6 +515,52 @@ static void parseDependentModules(bool isInternal) {
   sModNameSet.clear();
 }
 
+//
+// The modules named by the 'use' statements of one wave of files form the
+// next wave.  The files for a wave are located up front and parsed in the
+// same order as the loop above would parse them, while startPrefetch()'s
+// threads read the files that come later in the wave.
+//
+static void parseDependentModulesInWaves(bool isInternal) {
+  int waveStart = 0;
+
+  while (waveStart < sModNameList.n) {
+    int                      waveEnd = sModNameList.n;
+    std::vector<const char*> paths;
+    std::vector<ModTag>      modTags;
+
+    for (int i = waveStart; i < waveEnd; i++) {
+      const char* modName = sModNameList.v[i];
+      const char* path    = NULL;
+      ModTag      modTag  = MOD_INTERNAL;
+
+      if (sModDoneSet.set_in(modName) == NULL) {
+        path = modNameToPath(modName, isInternal, &modTag);
+      }
+
+      paths.push_back(path);
+      modTags.push_back(modTag);
+    }
+
+    startPrefetch(paths);
+
+    for (int i = waveStart; i < waveEnd; i++) {
+      const char* modName = sModNameList.v[i];
+      const char* path    = paths[i - waveStart];
+
+      if (sModDoneSet.set_in(modName)                    == NULL &&
+          path                                           != NULL &&
+          parseFile(path, modTags[i - waveStart], false) != NULL) {
+        sModDoneSet.set_add(modName);
+      }
+    }
+
+    finishPrefetch();
+
+    waveStart = waveEnd;
+  }
+}
+
 /************************************* | **************************************
 *                                                                             *
 *                                                                             *
@@ -479,21 +568,29 @@ static void parseDependentModules(bool isInternal) {
 ************************************** | *************************************/
 
 static ModuleSymbol* parseMod(const char* modName, bool isInternal) {
-  const char* path   = NULL;
   ModTag      modTag = MOD_INTERNAL;
+  const char* path   = modNameToPath(modName, isInternal, &modTag);
+
+  return (path != NULL) ? parseFile(path, modTag, false) : NULL;
+}
+
+static const char* modNameToPath(const char* modName,
+                                 bool        isInternal,
+                                 ModTag*     modTag) {
+  const char* path = NULL;
 
   if (isInternal == true) {
-    path   = searchThePath(modName, true, sIntModPath);
-    modTag = MOD_INTERNAL;
+    path    = searchThePath(modName, true, sIntModPath);
+    *modTag = MOD_INTERNAL;
 
   } else {
     bool isStandard = false;
 
-    path   = stdModNameToPath(modName, &isStandard);
-    modTag = isStandard ? MOD_STANDARD : MOD_USER;
+    path    = stdModNameToPath(modName, &isStandard);
+    *modTag = isStandard ? MOD_STANDARD : MOD_USER;
   }
 
-  return (path != NULL) ? parseFile(path, modTag, false) : NULL;
+  return path;
 }
 
 /************************************* | **************************************
@@ -534,14 +631,23 @@ static bool haveAlreadyParsed(const char* path) {
 static ModuleSymbol* parseFile(const char* path,
                                ModTag      modTag,
                                bool        namedOnCommandLine) {
-  ModuleSymbol* retval = NULL;
+  ModuleSymbol* retval     = NULL;
+  std::string   contents;
+  bool          prefetched = takePrefetchedFile(path, contents);
+  FILE*         fp         = NULL;
 
   // Make sure we haven't already parsed this file
   if (haveAlreadyParsed(path)) {
     return NULL;
   }
 
-  if (FILE* fp = openInputFile(path)) {
+  if (prefetched == false) {
+    fp = openInputFile(path);
+  }
+
+  if (prefetched == true || fp != NULL) {
+    YY_BUFFER_STATE handle = 0;
+
     gFilenameLookup.push_back(path);
 
     // State for the lexer
@@ -591,7 +697,11 @@ static ModuleSymbol* parseFile(const char* path,
 
     stringBufferInit();
 
-    yyset_in(fp, context.scanner);
+    if (prefetched == true) {
+      handle = yy_scan_bytes(contents.data(), contents.size(), context.scanner);
+    } else {
+      yyset_in(fp, context.scanner);
+    }
 
     while (lexerStatus != 0 && parserStatus == YYPUSH_MORE) {
       YYSTYPE yylval;
@@ -618,9 +728,15 @@ static ModuleSymbol* parseFile(const char* path,
     yypstate_delete(parser);
 
     // Cleanup after the lexer
+    if (handle != 0) {
+      yy_delete_buffer(handle, context.scanner);
+    }
+
     yylex_destroy(context.scanner);
 
-    closeInputFile(fp);
+    if (fp != NULL) {
+      closeInputFile(fp);
+    }
 
     // Halt now if there were parse errors.
     USR_STOP();
@@ -913,3 +1029,141 @@ static const char* searchThePath(const char*      modName,
 
   return retval;
 }
+
+/************************************* | **************************************
+*                                                                             *
+* Support for --parallel-parse                                                *
+*                                                                             *
+* Building the AST touches global state throughout the compiler (the astr()  *
+* table, the per-class AST lists, yyblock etc.) so the parse of each file     *
+* remains sequential.  What can be overlapped is the file I/O: a small pool   *
+* of threads reads the files of a wave into memory, in the order they will   *
+* be parsed, while the main thread parses the files that have already been   *
+* read.  A file that cannot be read here falls back to the ordinary path,     *
+* which also reports any error.                                               *
+*                                                                             *
+************************************** | *************************************/
+
+struct PrefetchedFile {
+  std::string contents;
+  bool        done;
+  bool        succeeded;
+};
+
+// The map itself is only changed by the main thread.  The reader threads
+// fill in the entries, and sPrefetchMutex guards the 'done' flags.
+static std::map<const char*, PrefetchedFile*> sPrefetchedFiles;
+static std::vector<std::thread>               sPrefetchThreads;
+static std::mutex                             sPrefetchMutex;
+static std::condition_variable                sPrefetchDone;
+
+static bool readFileContents(const char* path, std::string& contents) {
+  bool retval = false;
+
+  if (FILE* fp = fopen(path, "r")) {
+    char   buf[65536];
+    size_t n = 0;
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      contents.append(buf, n);
+    }
+
+    retval = ferror(fp) == 0;
+
+    fclose(fp);
+  }
+
+  return retval;
+}
+
+static void startPrefetch(const std::vector<const char*>& paths) {
+  std::vector<const char*>     toRead;
+  std::vector<PrefetchedFile*> files;
+  size_t                       numThreads = std::thread::hardware_concurrency();
+
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (paths[i] != NULL && sPrefetchedFiles.count(paths[i]) == 0) {
+      PrefetchedFile* file = new PrefetchedFile();
+
+      file->done      = false;
+      file->succeeded = false;
+
+      sPrefetchedFiles[paths[i]] = file;
+
+      toRead.push_back(paths[i]);
+      files.push_back(file);
+    }
+  }
+
+  numThreads = std::min(numThreads, toRead.size());
+
+  if (numThreads == 0 && toRead.size() > 0) {
+    numThreads = 1;
+  }
+
+  // Thread t reads files t, t + numThreads, t + 2 * numThreads ...
+  for (size_t t = 0; t < numThreads; t++) {
+    sPrefetchThreads.push_back(std::thread([=]() {
+      for (size_t i = t; i < toRead.size(); i += numThreads) {
+        std::string contents;
+        bool        succeeded = readFileContents(toRead[i], contents);
+
+        std::lock_guard<std::mutex> lock(sPrefetchMutex);
+
+        files[i]->contents.swap(contents);
+        files[i]->succeeded = succeeded;
+        files[i]->done      = true;
+
+        sPrefetchDone.notify_all();
+      }
+    }));
+  }
+}
+
+// Waits for the reader threads, and frees the files that were read but
+// not parsed (e.g. because they had already been parsed)
+static void finishPrefetch() {
+  std::map<const char*, PrefetchedFile*>::iterator it;
+
+  for (size_t t = 0; t < sPrefetchThreads.size(); t++) {
+    sPrefetchThreads[t].join();
+  }
+
+  sPrefetchThreads.clear();
+
+  for (it = sPrefetchedFiles.begin(); it != sPrefetchedFiles.end(); it++) {
+    delete it->second;
+  }
+
+  sPrefetchedFiles.clear();
+}
+
+// Waits until the file has been read, if it is being prefetched
+static bool takePrefetchedFile(const char* path, std::string& contents) {
+  std::map<const char*, PrefetchedFile*>::iterator it     = sPrefetchedFiles.find(path);
+  bool                                             retval = false;
+
+  if (it != sPrefetchedFiles.end()) {
+    PrefetchedFile* file = it->second;
+
+    {
+      std::unique_lock<std::mutex> lock(sPrefetchMutex);
+
+      while (file->done == false) {
+        sPrefetchDone.wait(lock);
+      }
+    }
+
+    if (file->succeeded == true) {
+      contents.swap(file->contents);
+
+      retval = true;
+    }
+
+    sPrefetchedFiles.erase(it);
+
+    delete file;
+  }
+
+  return retval;
+}
@@ -20,6 +20,7 @@
 #include "caches.h"
 
 #include "astutil.h"
+#include "driver.h"
 #include "stmt.h"
 #include "stringutil.h"
 
@@ -30,13 +31,44 @@
 *                                                                             *
 ************************************** | *************************************/
 
-SymbolMapCache genericsCache;
-SymbolMapCache promotionsCache;
+SymbolMapCache genericsCache("generics");
+SymbolMapCache promotionsCache("promotions");
 
-static bool isCacheEntryMatch(SymbolMap* s1, SymbolMap* s2);
+static size_t               cacheSignature(FnSymbol* oldFn, SymbolMap* map);
 
-SymbolMapCacheEntry::SymbolMapCacheEntry(FnSymbol* ifn, SymbolMap* imap) :
-  fn(ifn), map(*imap) { }
+static SymbolMapCacheEntry* findCacheEntry(SymbolMapCache& cache,
+                                           FnSymbol*       oldFn,
+                                           SymbolMap*      map);
+
+static bool isCacheEntryMatch(SymbolMap* s1,
+                              SymbolMap* s2,
+                              long&      nPairsCompared);
+
+SymbolMapCacheEntry::SymbolMapCacheEntry(FnSymbol*  ioldFn,
+                                         FnSymbol*  ifn,
+                                         SymbolMap* imap) :
+  oldFn(ioldFn), fn(ifn), map(*imap) { }
+
+SymbolMapCache::SymbolMapCache(const char* iname) {
+  name             = iname;
+  nLookups         = 0;
+  nHits            = 0;
+  nEntriesCompared = 0;
+  nPairsCompared   = 0;
+}
+
+void SymbolMapCache::printStatistics() const {
+  fprintf(stderr,
+          "%s cache: %ld entries, %ld lookups, %ld hits, %ld misses, "
+          "%ld entries compared, %ld pairs compared\n",
+          name,
+          (long) entries.size(),
+          nLookups,
+          nHits,
+          nLookups - nHits,
+          nEntriesCompared,
+          nPairsCompared);
+}
 
 
 void
@@ -44,29 +76,23 @@ addCache(SymbolMapCache& cache,
          FnSymbol*       oldFn,
          FnSymbol*       fn,
          SymbolMap*      map) {
-  Vec<SymbolMapCacheEntry*>* entries = cache.get(oldFn);
-  SymbolMapCacheEntry*       entry   = new SymbolMapCacheEntry(fn, map);
+  SymbolMapCacheEntry* entry = new SymbolMapCacheEntry(oldFn, fn, map);
 
-  if (entries) {
-    entries->add(entry);
-
-  } else {
-    entries = new Vec<SymbolMapCacheEntry*>();
-    entries->add(entry);
-    cache.put(oldFn, entries);
-  }
+  cache.entries.insert(std::make_pair(cacheSignature(oldFn, map), entry));
 }
 
 
 FnSymbol*
 checkCache(SymbolMapCache& cache, FnSymbol* oldFn, SymbolMap* map) {
-  if (Vec<SymbolMapCacheEntry*>* entries = cache.get(oldFn)) {
-    forv_Vec(SymbolMapCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(map, &entry->map))
-        return entry->fn;
-    }
+  SymbolMapCacheEntry* entry = findCacheEntry(cache, oldFn, map);
+
+  cache.nLookups = cache.nLookups + 1;
+
+  if (entry != NULL) {
+    cache.nHits = cache.nHits + 1;
   }
-  return NULL;
+
+  return (entry != NULL) ? entry->fn : NULL;
 }
 
 
@@ -75,38 +101,101 @@ replaceCache(SymbolMapCache& cache,
              FnSymbol*       oldFn,
              FnSymbol*       fn,
              SymbolMap*      map) {
-  if (Vec<SymbolMapCacheEntry*>* entries = cache.get(oldFn)) {
-    forv_Vec(SymbolMapCacheEntry, entry, *entries) {
-      if (isCacheEntryMatch(map, &entry->map)) {
-        entry->fn = fn;
-        return;
+  if (SymbolMapCacheEntry* entry = findCacheEntry(cache, oldFn, map)) {
+    entry->fn = fn;
+
+  } else {
+    INT_FATAL(oldFn, "unable to replace cache entry; entry does not exist");
+  }
+}
+
+
+void
+freeCache(SymbolMapCache& cache) {
+  SymbolMapCache::EntryMap::iterator it;
+
+  if (fPrintStatistics[0] != '\0') {
+    cache.printStatistics();
+  }
+
+  for (it = cache.entries.begin(); it != cache.entries.end(); ++it) {
+    delete it->second;
+  }
+
+  cache.entries.clear();
+
+  cache.nLookups         = 0;
+  cache.nHits            = 0;
+  cache.nEntriesCompared = 0;
+  cache.nPairsCompared   = 0;
+}
+
+static SymbolMapCacheEntry* findCacheEntry(SymbolMapCache& cache,
+                                           FnSymbol*       oldFn,
+                                           SymbolMap*      map) {
+  typedef SymbolMapCache::EntryMap::iterator Iterator;
+
+  std::pair<Iterator, Iterator> range;
+  SymbolMapCacheEntry*          retval = NULL;
+
+  range = cache.entries.equal_range(cacheSignature(oldFn, map));
+
+  for (Iterator it = range.first; it != range.second; ++it) {
+    SymbolMapCacheEntry* entry = it->second;
+
+    if (entry->oldFn == oldFn) {
+      cache.nEntriesCompared = cache.nEntriesCompared + 1;
+
+      if (isCacheEntryMatch(map, &entry->map, cache.nPairsCompared)) {
+        retval = entry;
+        break;
       }
     }
   }
 
-  INT_FATAL(oldFn, "unable to replace cache entry; entry does not exist");
+  return retval;
 }
 
+static size_t mixPointers(void* a, void* b) {
+  uint64_t h = (uint64_t) (uintptr_t) a * 0x9e3779b97f4a7c15ULL;
 
-void
-freeCache(SymbolMapCache& cache) {
-  form_Map(SymbolMapCacheElem, elem, cache) {
-    forv_Vec(SymbolMapCacheEntry, entry, *elem->value) {
-      delete entry;
+  h = (h ^ (uint64_t) (uintptr_t) b) * 0xbf58476d1ce4e5b9ULL;
+
+  return (size_t) (h ^ (h >> 31));
+}
+
+//
+// Summing the hashes of the key-value pairs makes the signature
+// independent of the order in which the SymbolMap stores them.  Pairs
+// with a NULL value are skipped since isCacheEntryMatch() treats them
+// the same as a missing key.
+//
+static size_t cacheSignature(FnSymbol* oldFn, SymbolMap* map) {
+  size_t retval = mixPointers(oldFn, NULL);
+
+  form_Map(SymbolMapElem, e, *map) {
+    if (e->value != NULL) {
+      retval = retval + mixPointers(e->key, e->value);
     }
-    delete elem->value;
   }
-  cache.clear();
+
+  return retval;
 }
 
-static bool isCacheEntryMatch(SymbolMap* s1, SymbolMap* s2) {
+static bool isCacheEntryMatch(SymbolMap* s1,
+                              SymbolMap* s2,
+                              long&      nPairsCompared) {
   form_Map(SymbolMapElem, e, *s1) {
+    nPairsCompared = nPairsCompared + 1;
+
     if (s2->get(e->key) != e->value) {
       return false;
     }
   }
 
   form_Map(SymbolMapElem, e, *s2) {
+    nPairsCompared = nPairsCompared + 1;
+
     if (s1->get(e->key) != e->value) {
       return false;
     }
@@ -22,6 +22,8 @@
 
 #include "baseAST.h"
 
+#include <unordered_map>
+
 //
 // SymbolMapCache: FnSymbol -> FnSymbol cache based on a SymbolMap
 //
@@ -35,16 +37,36 @@
 //
 //   freeCache(cache): frees memory associated with cache
 //
+//   Entries are keyed by a hash of old_fn and the key-value pairs of
+//   the map that does not depend on their order, so a lookup only
+//   compares maps that share that signature.
+//
 class SymbolMapCacheEntry {
 public:
-  SymbolMapCacheEntry(FnSymbol* ifn, SymbolMap* imap);
+  SymbolMapCacheEntry(FnSymbol* ioldFn, FnSymbol* ifn, SymbolMap* imap);
 
+  FnSymbol* oldFn;
   FnSymbol* fn;
   SymbolMap map;
 };
 
-typedef Map<FnSymbol*,     Vec<SymbolMapCacheEntry*>*> SymbolMapCache;
-typedef MapElem<FnSymbol*, Vec<SymbolMapCacheEntry*>*> SymbolMapCacheElem;
+class SymbolMapCache {
+public:
+  typedef std::unordered_multimap<size_t, SymbolMapCacheEntry*> EntryMap;
+
+                     SymbolMapCache(const char* name);
+
+  void               printStatistics()                                  const;
+
+  const char*        name;
+  EntryMap           entries;
+
+  // Reported by --print-statistics
+  long               nLookups;
+  long               nHits;
+  long               nEntriesCompared;
+  long               nPairsCompared;
+};
 
 
 void      addCache(SymbolMapCache& cache,
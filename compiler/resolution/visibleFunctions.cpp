@@ -22,6 +22,7 @@
 #include "callInfo.h"
 #include "driver.h"
 #include "expr.h"
+#include "flatHashMap.h"
 #include "map.h"
 #include "resolution.h"
 #include "resolveIntents.h"
@@ -32,6 +33,8 @@
 
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 
 /*
@@ -49,19 +52,73 @@
    symbols available to all modules (i.e. what is in ChapelStandard)
    is considered to be in a single block. This optimization
    provides a significant performance improvement for compiling 'hello'.
+
+   Walking the visibility chain is still expensive for common names
+   such as '=', 'init' or 'these', which are looked up from the same
+   scopes over and over again.  The result of a walk is therefore
+   memoized in a second table
+
+     visibility scope -> name -> flattened FnSymbol*s
+
+   An entry remains valid until a function that it could have found is
+   added to 'visibleFunctionMap', a 'use' list changes, or one of the
+   instantiation points consulted during the walk moves.
  */
 
 class VisibleFunctionBlock {
 public:
                                         VisibleFunctionBlock();
 
-  Map<const char*, Vec<FnSymbol*>*>     visibleFunctions;
+  FlatHashMap<const char*,
+              Vec<FnSymbol*>*>          visibleFunctions;
 };
 
-static Map<BlockStmt*, VisibleFunctionBlock*> visibleFunctionMap;
+class VisibleFunctionCacheEntry {
+public:
+                                        VisibleFunctionCacheEntry();
+
+  bool                                  isValid(const char* name)     const;
+  void                                  reset();
+
+  Vec<FnSymbol*>                        fns;
+
+  // The epoch in which 'fns' was computed
+  int                                   epoch;
+
+  // Names, other than the one requested, searched due to 'use' renames
+  std::vector<const char*>              renames;
+
+  // The instantiation point found for each generic function block visited
+  std::vector<std::pair<FnSymbol*, BlockStmt*> > instantiationPts;
+};
+
+// Index 0 is for ordinary calls and index 1 for method calls, since a
+// 'use' with an 'only' or 'except' list can filter the two differently.
+class VisibleFunctionCache {
+public:
+                                        VisibleFunctionCache();
+
+  FlatHashMap<const char*,
+              VisibleFunctionCacheEntry*> entries[2];
+};
+
+static FlatHashMap<BlockStmt*, VisibleFunctionBlock*> visibleFunctionMap;
 
 static int                                    nVisibleFunctions       = 0;
 
+static FlatHashMap<BlockStmt*, VisibleFunctionCache*> visibleFunctionCache;
+
+// Bumped whenever a function is added to visibleFunctionMap.  nameEpochs
+// remembers the last epoch in which a function with a given name was added,
+// and useListEpoch the last epoch in which any 'use' list was modified.
+static int                                    visibleFunctionsEpoch   = 1;
+static FlatHashMap<const char*, int>          nameEpochs;
+static int                                    useListEpoch            = 0;
+
+static int                                    nCacheLookups           = 0;
+static int                                    nCacheHits              = 0;
+static int                                    nCacheInvalidations     = 0;
+
 
 
 /************************************* | **************************************
@@ -141,9 +198,13 @@ static void buildVisibleFunctionMap() {
         vfb->visibleFunctions.put(fn->name, fns);
       }
       fns->add(fn);
+
+      nameEpochs.put(fn->name, visibleFunctionsEpoch);
     }
   }
   nVisibleFunctions = gFnSymbols.n;
+
+  visibleFunctionsEpoch++;
 }
 
 /************************************* | **************************************
@@ -154,28 +215,93 @@ static void buildVisibleFunctionMap() {
 *                                                                             *
 ************************************** | *************************************/
 
-static void getVisibleFunctions(const char*           name,
-                                CallExpr*             call,
-                                BlockStmt*            block,
-                                std::set<BlockStmt*>& visited,
-                                Vec<FnSymbol*>&       visibleFns,
-                                bool inUseChain);
+static void getVisibleFunctions(const char*                name,
+                                CallExpr*                  call,
+                                BlockStmt*                 block,
+                                std::set<BlockStmt*>&      visited,
+                                Vec<FnSymbol*>&            visibleFns,
+                                bool                       inUseChain,
+                                VisibleFunctionCacheEntry* entry);
+
+static void getCachedVisibleFunctions(const char*     name,
+                                      CallExpr*       call,
+                                      BlockStmt*      block,
+                                      Vec<FnSymbol*>& visibleFns);
+
+static bool isMethodCall(CallExpr* call);
 
 void getVisibleFunctions(const char*      name,
                          CallExpr*        call,
                          Vec<FnSymbol*>&  visibleFns) {
-  BlockStmt*           block    = getVisibilityScope(call);
-  std::set<BlockStmt*> visited;
+  BlockStmt* block = getVisibilityScope(call);
+
+  if (fNoVisibleFunctionCache == true || call->id == breakOnResolveID) {
+    std::set<BlockStmt*> visited;
+
+    getVisibleFunctions(name, call, block, visited, visibleFns, false, NULL);
+
+  } else {
+    getCachedVisibleFunctions(name, call, block, visibleFns);
+  }
+}
+
+//
+// The walk below depends on the call only through its visibility scope,
+// whether or not it is a method call, and the privacy checks.  The latter
+// walk up the scopes enclosing the call, which are the same for every call
+// that shares a visibility scope.
+//
+static void getCachedVisibleFunctions(const char*     name,
+                                      CallExpr*       call,
+                                      BlockStmt*      block,
+                                      Vec<FnSymbol*>& visibleFns) {
+  VisibleFunctionCache*      cache = visibleFunctionCache.get(block);
+  VisibleFunctionCacheEntry* entry = NULL;
+  int                        index = isMethodCall(call) ? 1 : 0;
+
+  nCacheLookups++;
+
+  if (cache == NULL) {
+    cache = new VisibleFunctionCache();
+    visibleFunctionCache.put(block, cache);
+  }
+
+  entry = cache->entries[index].get(name);
+
+  if (entry == NULL) {
+    entry = new VisibleFunctionCacheEntry();
+    cache->entries[index].put(name, entry);
+
+  } else if (entry->isValid(name) == true) {
+    nCacheHits++;
+
+  } else {
+    nCacheInvalidations++;
+    entry->reset();
+  }
+
+  if (entry->epoch == 0) {
+    std::set<BlockStmt*> visited;
+
+    getVisibleFunctions(name, call, block, visited, entry->fns, false, entry);
+
+    entry->epoch = visibleFunctionsEpoch;
+  }
+
+  visibleFns.append(entry->fns);
+}
 
-  getVisibleFunctions(name, call, block, visited, visibleFns, false);
+static bool isMethodCall(CallExpr* call) {
+  return call->numActuals() >= 2 && call->get(1)->typeInfo() == dtMethodToken;
 }
 
-static void getVisibleFunctions(const char*           name,
-                                CallExpr*             call,
-                                BlockStmt*            block,
-                                std::set<BlockStmt*>& visited,
-                                Vec<FnSymbol*>&       visibleFns,
-                                bool inUseChain) {
+static void getVisibleFunctions(const char*                name,
+                                CallExpr*                  call,
+                                BlockStmt*                 block,
+                                std::set<BlockStmt*>&      visited,
+                                Vec<FnSymbol*>&            visibleFns,
+                                bool                       inUseChain,
+                                VisibleFunctionCacheEntry* entry) {
 
   //
   // avoid infinite recursion due to modules with mutual uses
@@ -206,6 +332,10 @@ static void getVisibleFunctions(const char*           name,
       }
       if (inFnInstantiationPoint && inFnInstantiationPoint->parentSymbol)
         instantiationPt = inFnInstantiationPoint;
+
+      if (entry != NULL)
+        entry->instantiationPts.push_back(std::make_pair(inFn,
+                                                         instantiationPt));
     }
 
     if (call->id == breakOnResolveID) {
@@ -284,12 +414,7 @@ static void getVisibleFunctions(const char*           name,
         // available to us
         if (!inUseChain || !use->isPrivate) {
 
-          bool isMethodCall = false;
-          if (call->numActuals() >= 2 &&
-              call->get(1)->typeInfo() == dtMethodToken)
-            isMethodCall = true;
-
-          if (use->skipSymbolSearch(name, isMethodCall) == false) {
+          if (use->skipSymbolSearch(name, isMethodCall(call)) == false) {
             SymExpr* se = toSymExpr(use->src);
 
             INT_ASSERT(se);
@@ -300,18 +425,24 @@ static void getVisibleFunctions(const char*           name,
 
               if (mod->isVisible(call) == true) {
                 if (use->isARename(name) == true) {
-                  getVisibleFunctions(use->getRename(name),
+                  const char* rename = use->getRename(name);
+
+                  if (entry != NULL)
+                    entry->renames.push_back(rename);
+
+                  getVisibleFunctions(rename,
                                       call,
                                       mod->block,
                                       visited,
                                       visibleFns,
-                                      true);
+                                      true,
+                                      entry);
                 } else {
                   getVisibleFunctions(name,
                                       call,
                                       mod->block,
                                       visited,
-                                      visibleFns, true);
+                                      visibleFns, true, entry);
                 }
               }
             }
@@ -324,12 +455,13 @@ static void getVisibleFunctions(const char*           name,
       BlockStmt* next  = getVisibilityScope(block);
 
       // Recurse in the enclosing block
-      getVisibleFunctions(name, call, next, visited, visibleFns, inUseChain);
+      getVisibleFunctions(name, call, next, visited, visibleFns, inUseChain,
+                          entry);
 
       if (instantiationPt != NULL) {
         // Also look at the instantiation point
         getVisibleFunctions(name, call, instantiationPt, visited, visibleFns,
-                            inUseChain);
+                            inUseChain, entry);
       }
     }
   } else if (!inUseChain) {
@@ -355,6 +487,10 @@ static void getVisibleFunctions(const char*           name,
       }
       if (inFnInstantiationPoint && inFnInstantiationPoint->parentSymbol)
         instantiationPt = inFnInstantiationPoint;
+
+      if (entry != NULL)
+        entry->instantiationPts.push_back(std::make_pair(inFn,
+                                                         instantiationPt));
     }
 
     if (block->useList != NULL) {
@@ -369,12 +505,7 @@ static void getVisibleFunctions(const char*           name,
         // was seen
         if (use->isPrivate) {
 
-          bool isMethodCall = false;
-          if (call->numActuals() >= 2 &&
-              call->get(1)->typeInfo() == dtMethodToken)
-            isMethodCall = true;
-
-          if (use->skipSymbolSearch(name, isMethodCall) == false) {
+          if (use->skipSymbolSearch(name, isMethodCall(call)) == false) {
             SymExpr* se = toSymExpr(use->src);
 
             INT_ASSERT(se);
@@ -385,18 +516,24 @@ static void getVisibleFunctions(const char*           name,
 
               if (mod->isVisible(call) == true) {
                 if (use->isARename(name) == true) {
-                  getVisibleFunctions(use->getRename(name),
+                  const char* rename = use->getRename(name);
+
+                  if (entry != NULL)
+                    entry->renames.push_back(rename);
+
+                  getVisibleFunctions(rename,
                                       call,
                                       mod->block,
                                       visited,
                                       visibleFns,
-                                      true);
+                                      true,
+                                      entry);
                 } else {
                   getVisibleFunctions(name,
                                       call,
                                       mod->block,
                                       visited,
-                                      visibleFns, true);
+                                      visibleFns, true, entry);
                 }
               }
             }
@@ -411,13 +548,14 @@ static void getVisibleFunctions(const char*           name,
       BlockStmt* next  = getVisibilityScope(block);
 
       // Recurse in the enclosing block
-      getVisibleFunctions(name, call, next, visited, visibleFns, inUseChain);
+      getVisibleFunctions(name, call, next, visited, visibleFns, inUseChain,
+                          entry);
     }
 
     if (instantiationPt != NULL) {
       // Also look at the instantiation point
       getVisibleFunctions(name, call, instantiationPt, visited, visibleFns,
-                          inUseChain);
+                          inUseChain, entry);
     }
   }
 }
@@ -518,8 +656,53 @@ BlockStmt* getVisibilityScope(Expr* expr) {
 *                                                                             *
 ************************************** | *************************************/
 
+void visibleFunctionsInvalidateUses() {
+  useListEpoch = visibleFunctionsEpoch++;
+}
+
 void visibleFunctionsClear() {
   Vec<VisibleFunctionBlock*> vfbs;
+  Vec<VisibleFunctionCache*> caches;
+
+  if ((printPasses == true || printPassesFile != NULL) && nCacheLookups > 0) {
+    char text[128];
+
+    snprintf(text, sizeof(text),
+             "%32s :%9d lookups %9d hits %7d invalidated\n",
+             "visible function cache",
+             nCacheLookups,
+             nCacheHits,
+             nCacheInvalidations);
+
+    if (printPasses == true)
+      fputs(text, stderr);
+
+    if (printPassesFile != NULL)
+      fputs(text, printPassesFile);
+  }
+
+  visibleFunctionCache.get_values(caches);
+
+  forv_Vec(VisibleFunctionCache, cache, caches) {
+    for (int i = 0; i < 2; i++) {
+      Vec<VisibleFunctionCacheEntry*> entries;
+
+      cache->entries[i].get_values(entries);
+
+      forv_Vec(VisibleFunctionCacheEntry, entry, entries) {
+        delete entry;
+      }
+    }
+
+    delete cache;
+  }
+
+  visibleFunctionCache.clear();
+  nameEpochs.clear();
+
+  nCacheLookups       = 0;
+  nCacheHits          = 0;
+  nCacheInvalidations = 0;
 
   visibleFunctionMap.get_values(vfbs);
 
@@ -547,3 +730,38 @@ void visibleFunctionsClear() {
 VisibleFunctionBlock::VisibleFunctionBlock() {
 
 }
+
+VisibleFunctionCache::VisibleFunctionCache() {
+
+}
+
+VisibleFunctionCacheEntry::VisibleFunctionCacheEntry() {
+  epoch = 0;
+}
+
+void VisibleFunctionCacheEntry::reset() {
+  fns.clear();
+  renames.clear();
+  instantiationPts.clear();
+
+  epoch = 0;
+}
+
+bool VisibleFunctionCacheEntry::isValid(const char* name) const {
+  if (epoch <= useListEpoch || epoch <= nameEpochs.get(name))
+    return false;
+
+  for (size_t i = 0; i < renames.size(); i++) {
+    if (epoch <= nameEpochs.get(renames[i]))
+      return false;
+  }
+
+  for (size_t i = 0; i < instantiationPts.size(); i++) {
+    FnSymbol* fn = instantiationPts[i].first;
+
+    if (fn->instantiationPoint() != instantiationPts[i].second)
+      return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,295 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "buildCache.h"
+
+#include "docsDriver.h"
+#include "driver.h"
+#include "expr.h"
+#include "files.h"
+#include "fingerprint.h"
+#include "insertLineNumbers.h"
+#include "misc.h"
+#include "ModuleSymbol.h"
+#include "stlUtil.h"
+#include "stringutil.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+char fBuildCacheDir[FILENAME_MAX+1] = "";
+
+static bool        isBuildCacheEnabled();
+static const char* outputFilename();
+static const char* buildCacheEntryDir();
+static void        addFileToKey(Fingerprint& key, const char* path);
+static void        addStatToKey(Fingerprint& key, const char* path);
+static void        addLibrariesToKey(Fingerprint& key);
+static const char* findRequiredHeader(const char* path);
+static bool        copyExecutable(const char* from, const char* to);
+static bool        fileExists(const char* path);
+
+static void        printBuildCacheNote(const char* what);
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+bool buildCacheLookup() {
+  bool retval = false;
+
+  if (isBuildCacheEnabled() == true) {
+    const char* entry   = buildCacheEntryDir();
+    const char* exe     = astr(entry, "/", "exe");
+    const char* exeReal = astr(entry, "/", "exe_real");
+
+    if (fileExists(exe) == true) {
+      const char* output = outputFilename();
+
+      retval = copyExecutable(exe, output);
+
+      if (retval == true && fileExists(exeReal) == true) {
+        retval = copyExecutable(exeReal, astr(output, "_real"));
+      }
+
+      printBuildCacheNote(retval ? "hit" : "unusable entry");
+    } else {
+      printBuildCacheNote("miss");
+    }
+  }
+
+  return retval;
+}
+
+void buildCacheStore() {
+  if (isBuildCacheEnabled() == true && fileExists(executableFilename)) {
+    const char* entry   = buildCacheEntryDir();
+    const char* tmp     = astr(entry, ".tmp", istr((int) getpid()));
+    const char* exeReal = astr(executableFilename, "_real");
+    bool        ok      = true;
+
+    ensureDirExists(tmp, "creating build cache entry");
+
+    ok = copyExecutable(executableFilename, astr(tmp, "/", "exe"));
+
+    if (ok == true && fileExists(exeReal) == true) {
+      ok = copyExecutable(exeReal, astr(tmp, "/", "exe_real"));
+    }
+
+    // Publish the entry atomically.  If a concurrent compilation won the
+    // race, its entry is equivalent to ours and ours is discarded.
+    if (ok == false || rename(tmp, entry) != 0) {
+      deleteDir(tmp);
+    }
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+static bool isBuildCacheEnabled() {
+  return fBuildCacheDir[0]  != '\0'  &&
+         fLibraryCompile    == false &&
+         fDocs              == false &&
+         fParseOnly         == false &&
+         no_codegen         == false &&
+         saveCDir[0]        == '\0'  &&
+         stopAfterPass[0]   == '\0';
+}
+
+// The default executable name is normally set during codegen
+static const char* outputFilename() {
+  const char* retval = executableFilename;
+
+  if (retval[0] == '\0') {
+    ModuleSymbol* mainMod  = ModuleSymbol::mainModule();
+    const char*   filename = stripdirectories(mainMod->astloc.filename);
+    const char*   lastDot  = strrchr(filename, '.');
+
+    if (lastDot != NULL) {
+      retval = asubstr(filename, lastDot);
+    } else {
+      retval = astr(filename);
+    }
+  }
+
+  return retval;
+}
+
+static const char* buildCacheEntryDir() {
+  static const char* sEntry = NULL;
+
+  if (sEntry == NULL) {
+    Fingerprint key;
+
+    key.add(compileVersion);
+    key.add(compileCommand);
+    key.add(getCwd());
+
+    for (std::map<std::string, const char*>::iterator it = envMap.begin();
+         it != envMap.end();
+         ++it) {
+      if (strncmp(it->first.c_str(), "CHPL_", 5) == 0) {
+        key.add(it->first);
+        key.add(it->second);
+      }
+    }
+
+    // The compiler and the runtime can be rebuilt without a version change
+    addStatToKey(key, "/proc/self/exe");
+    addStatToKey(key, astr(CHPL_RUNTIME_LIB, "/", CHPL_RUNTIME_SUBDIR,
+                           "/libchpl.a"));
+
+    for (size_t i = 0; i < gFilenameLookup.size(); i++) {
+      addFileToKey(key, gFilenameLookup[i].c_str());
+    }
+
+    for (int i = 0; nthFilename(i) != NULL; i++) {
+      const char* path = nthFilename(i);
+
+      if (isCHeader(path) == true) {
+        path = findRequiredHeader(path);
+      }
+
+      addFileToKey(key, path);
+    }
+
+    addLibrariesToKey(key);
+
+    ensureDirExists(fBuildCacheDir, "creating build cache directory");
+
+    sEntry = astr(fBuildCacheDir, "/", key.toString().c_str());
+  }
+
+  return sEntry;
+}
+
+static void addFileToKey(Fingerprint& key, const char* path) {
+  key.add(path);
+
+  // Names that are not files, e.g. "<internal>", contribute just the name
+  if (key.addFile(path) == false) {
+    key.add((uint64_t) 0);
+  }
+}
+
+static void addStatToKey(Fingerprint& key, const char* path) {
+  struct stat sb;
+
+  if (stat(path, &sb) == 0) {
+    key.add((uint64_t) sb.st_size);
+    key.add((uint64_t) sb.st_mtime);
+  }
+}
+
+// Libraries named by -l on the command line, and by 'require "-lfoo"'.
+// The lookup happens right after parsing, before resolution has added
+// the required libraries to libFiles, so take those from the AST.
+static void addLibrariesToKey(Fingerprint& key) {
+  for_vector(const char, libName, libFiles) {
+    key.add(libName);
+  }
+
+  forv_Vec(CallExpr, call, gCallExprs) {
+    if (call->isPrimitive(PRIM_REQUIRE) == true) {
+      const char* str = NULL;
+
+      if (get_string(call->get(1), &str) == true &&
+          strncmp(str, "-l", 2) == 0) {
+        key.add(str);
+      }
+    }
+  }
+}
+
+// Headers are found via the -I path when the C code is compiled
+static const char* findRequiredHeader(const char* path) {
+  if (fileExists(path) == false && path[0] != '/') {
+    for (size_t i = 0; i < incDirs.size(); i++) {
+      const char* candidate = astr(incDirs[i], "/", path);
+
+      if (fileExists(candidate) == true) {
+        return candidate;
+      }
+    }
+  }
+
+  return path;
+}
+
+static bool copyExecutable(const char* from, const char* to) {
+  FILE* in     = fopen(from, "rb");
+  FILE* out    = NULL;
+  bool  retval = false;
+
+  if (in != NULL) {
+    // Remove any old file first; it may be running or read-only
+    unlink(to);
+
+    out = fopen(to, "wb");
+
+    if (out != NULL) {
+      char   buf[65536];
+      size_t n = 0;
+
+      retval = true;
+
+      while ((n = fread(buf, 1, sizeof(buf), in)) > 0 && retval == true) {
+        retval = fwrite(buf, 1, n, out) == n;
+      }
+
+      retval = (fclose(out) == 0) && retval && ferror(in) == 0;
+
+      if (retval == true) {
+        retval = chmod(to, 0755) == 0;
+      }
+    }
+
+    fclose(in);
+  }
+
+  if (retval == false) {
+    USR_WARN("build cache: unable to copy '%s' to '%s': %s",
+             from, to, strerror(errno));
+  }
+
+  return retval;
+}
+
+static bool fileExists(const char* path) {
+  struct stat sb;
+
+  return stat(path, &sb) == 0 && S_ISREG(sb.st_mode);
+}
+
+static void printBuildCacheNote(const char* what) {
+  if (printPasses == true)
+    fprintf(stderr, "%32s : %s\n", "build cache", what);
+
+  if (printPassesFile != NULL)
+    fprintf(printPassesFile, "%32s : %s\n", "build cache", what);
+}
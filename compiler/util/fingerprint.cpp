@@ -0,0 +1,104 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fingerprint.h"
+
+#include <cstdio>
+#include <cstring>
+
+//
+// The two halves are independent 64-bit hashes: FNV-1a, and a
+// multiply-rotate hash with a different prime.  Neither is
+// cryptographic, but together they make accidental collisions between
+// cache keys vanishingly unlikely.
+//
+static const uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+static const uint64_t kFnvPrime  = 0x00000100000001b3ULL;
+
+static const uint64_t kMixSeed   = 0x9e3779b97f4a7c15ULL;
+static const uint64_t kMixPrime  = 0xff51afd7ed558ccdULL;
+
+Fingerprint::Fingerprint() {
+  mHash1 = kFnvOffset;
+  mHash2 = kMixSeed;
+}
+
+void Fingerprint::add(const char* str) {
+  add(str, (str != NULL) ? strlen(str) : 0);
+}
+
+void Fingerprint::add(const std::string& str) {
+  add(str.c_str(), str.length());
+}
+
+void Fingerprint::add(uint64_t value) {
+  add(&value, sizeof(value));
+}
+
+void Fingerprint::add(const void* data, size_t len) {
+  uint64_t len64 = len;
+
+  addBytes(&len64, sizeof(len64));
+  addBytes(data,   len);
+}
+
+bool Fingerprint::addFile(const char* path) {
+  FILE* fp     = fopen(path, "rb");
+  bool  retval = false;
+
+  if (fp != NULL) {
+    char     buf[65536];
+    size_t   n     = 0;
+    uint64_t total = 0;
+
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      addBytes(buf, n);
+      total = total + n;
+    }
+
+    retval = ferror(fp) == 0;
+
+    fclose(fp);
+
+    add(total);
+  }
+
+  return retval;
+}
+
+std::string Fingerprint::toString() const {
+  char buf[33];
+
+  snprintf(buf, sizeof(buf), "%016llx%016llx",
+           (unsigned long long) mHash1,
+           (unsigned long long) mHash2);
+
+  return std::string(buf);
+}
+
+void Fingerprint::addBytes(const void* data, size_t len) {
+  const unsigned char* bytes = (const unsigned char*) data;
+
+  for (size_t i = 0; i < len; i++) {
+    mHash1 = (mHash1 ^ bytes[i]) * kFnvPrime;
+
+    mHash2 = (mHash2 + bytes[i]) * kMixPrime;
+    mHash2 = (mHash2 << 29) | (mHash2 >> 35);
+  }
+}
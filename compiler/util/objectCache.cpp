@@ -0,0 +1,262 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "objectCache.h"
+
+#include "driver.h"
+#include "files.h"
+#include "fingerprint.h"
+#include "misc.h"
+#include "stringutil.h"
+
+#include <cerrno>
+#include <cstring>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+char fObjectCacheDir[FILENAME_MAX+1] = "";
+
+struct CachedObject {
+  const char* object;
+  const char* entry;
+};
+
+// The objects that make has to build, and where to store them
+static std::vector<CachedObject> sMisses;
+
+static const char* objectCacheEntry(const char* object);
+static void        addCommonKey(Fingerprint& key);
+static void        addGeneratedFile(Fingerprint&           key,
+                                    const char*            path,
+                                    std::set<std::string>& visited);
+static void        addStatToKey(Fingerprint& key, const char* path);
+static bool        copyObject(const char* from, const char* to);
+static bool        fileExists(const char* path);
+
+static void        printObjectCacheNote(int hits, int misses);
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+bool objectCacheEnabled() {
+  return fObjectCacheDir[0] != '\0' && no_codegen == false;
+}
+
+void objectCacheRestore(const std::vector<const char*>& objects) {
+  if (objectCacheEnabled() == true && objects.size() > 0) {
+    int hits = 0;
+
+    ensureDirExists(fObjectCacheDir, "creating object cache directory");
+
+    sMisses.clear();
+
+    for (size_t i = 0; i < objects.size(); i++) {
+      const char* entry = objectCacheEntry(objects[i]);
+
+      if (fileExists(entry) == true && copyObject(entry, objects[i])) {
+        hits = hits + 1;
+
+      } else {
+        CachedObject miss = { objects[i], entry };
+
+        sMisses.push_back(miss);
+      }
+    }
+
+    printObjectCacheNote(hits, (int) sMisses.size());
+  }
+}
+
+void objectCacheStore() {
+  for (size_t i = 0; i < sMisses.size(); i++) {
+    const char* tmp = astr(sMisses[i].entry, ".tmp", istr((int) getpid()));
+
+    // Publish the entry atomically; a concurrent compilation that stored
+    // the same key produced an equivalent object.
+    if (fileExists(sMisses[i].object) == false    ||
+        copyObject(sMisses[i].object, tmp) == false ||
+        rename(tmp, sMisses[i].entry) != 0) {
+      unlink(tmp);
+    }
+  }
+
+  sMisses.clear();
+}
+
+/************************************* | **************************************
+*                                                                             *
+*                                                                             *
+*                                                                             *
+************************************** | *************************************/
+
+static const char* objectCacheEntry(const char* object) {
+  Fingerprint           key;
+  std::set<std::string> visited;
+
+  addCommonKey(key);
+  addGeneratedFile(key, astr(object, ".c"), visited);
+
+  return astr(fObjectCacheDir, "/", key.toString().c_str(), ".o");
+}
+
+static void addCommonKey(Fingerprint& key) {
+  key.add(compileVersion);
+
+  for (std::map<std::string, const char*>::iterator it = envMap.begin();
+       it != envMap.end();
+       ++it) {
+    if (strncmp(it->first.c_str(), "CHPL_", 5) == 0) {
+      key.add(it->first);
+      key.add(it->second);
+    }
+  }
+
+  // The compiler and the runtime (and so its headers) can be rebuilt
+  // without a version change
+  addStatToKey(key, "/proc/self/exe");
+  addStatToKey(key, astr(CHPL_RUNTIME_LIB, "/", CHPL_RUNTIME_SUBDIR,
+                         "/libchpl.a"));
+
+  key.add(ccflags);
+  key.add((uint64_t) ccwarnings);
+  key.add((uint64_t) debugCCode);
+  key.add((uint64_t) optimizeCCode);
+  key.add((uint64_t) specializeCCode);
+  key.add((uint64_t) ffloatOpt);
+  key.add((uint64_t) fLinkStyle);
+
+  for (size_t i = 0; i < incDirs.size(); i++) {
+    key.add(incDirs[i]);
+  }
+}
+
+//
+// Adds a generated file and, recursively, the generated files that it
+// #includes.  Files outside the intermediate directory (the runtime and
+// system headers) are covered by addCommonKey().
+//
+static void addGeneratedFile(Fingerprint&           key,
+                             const char*            path,
+                             std::set<std::string>& visited) {
+  const char* dir = getDirectory(path);
+  FILE*       fp  = NULL;
+
+  if (visited.insert(path).second == false) {
+    return;
+  }
+
+  key.add(stripdirectories(path));
+
+  if (key.addFile(path) == false) {
+    key.add((uint64_t) 0);
+    return;
+  }
+
+  fp = fopen(path, "r");
+
+  if (fp != NULL) {
+    const char* prefix = "#include \"";
+    size_t      len    = strlen(prefix);
+    char        line[1024];
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+      if (strncmp(line, prefix, len) == 0) {
+        char* name = line + len;
+        char* end  = strchr(name, '"');
+
+        if (end != NULL) {
+          const char* included = NULL;
+
+          *end     = '\0';
+          included = astr(dir, "/", name);
+
+          if (fileExists(included) == true) {
+            addGeneratedFile(key, included, visited);
+          }
+        }
+      }
+    }
+
+    fclose(fp);
+  }
+}
+
+static void addStatToKey(Fingerprint& key, const char* path) {
+  struct stat sb;
+
+  if (stat(path, &sb) == 0) {
+    key.add((uint64_t) sb.st_size);
+    key.add((uint64_t) sb.st_mtime);
+  }
+}
+
+static bool copyObject(const char* from, const char* to) {
+  FILE* in     = fopen(from, "rb");
+  FILE* out    = NULL;
+  bool  retval = false;
+
+  if (in != NULL) {
+    out = fopen(to, "wb");
+
+    if (out != NULL) {
+      char   buf[65536];
+      size_t n = 0;
+
+      retval = true;
+
+      while ((n = fread(buf, 1, sizeof(buf), in)) > 0 && retval == true) {
+        retval = fwrite(buf, 1, n, out) == n;
+      }
+
+      retval = (fclose(out) == 0) && retval && ferror(in) == 0;
+    }
+
+    fclose(in);
+  }
+
+  if (retval == false) {
+    USR_WARN("object cache: unable to copy '%s' to '%s': %s",
+             from, to, strerror(errno));
+
+    unlink(to);
+  }
+
+  return retval;
+}
+
+static bool fileExists(const char* path) {
+  struct stat sb;
+
+  return stat(path, &sb) == 0 && S_ISREG(sb.st_mode);
+}
+
+static void printObjectCacheNote(int hits, int misses) {
+  if (printPasses == true)
+    fprintf(stderr, "%32s : %d hits, %d misses\n",
+            "object cache", hits, misses);
+
+  if (printPassesFile != NULL)
+    fprintf(printPassesFile, "%32s : %d hits, %d misses\n",
+            "object cache", hits, misses);
+}
@@ -170,10 +170,6 @@ module ChapelArray {
   private use ChapelDebugPrint;
   private use SysCTypes;
 
-  // Explicitly use a processor atomic, as most calls to this function are
-  // likely be on locale 0
-  pragma "no doc"
-  var numPrivateObjects: chpl__processorAtomicType(int);
   pragma "no doc"
   param nullPid = -1;
 
@@ -217,19 +213,26 @@ module ChapelArray {
   //    relatively low overhead, adds work to Locale 0 that is not present on
   //    the other locales, and again would be surprising if a Block array were
   //    created over other locales only (say, Locales[2] and Locales[3]).
+  //
+  // Locale 0 hands out the pids, and reuses those of freed objects once
+  // every locale has cleared its copy.
 
   // Given a dsi Dist/Dom/Array, create an pid integer identifying the
   // privatized version on all locales; and populate each locale
   // with a privatized value that can be retrieved by the pid
   // without communication.
   proc _newPrivatizedClass(value) : int {
+    extern proc chpl_privatization_newPid(): int;
 
-    const n = numPrivateObjects.fetchAdd(1);
+    var n: int;
 
     const hereID = here.id;
     const privatizeData = value.dsiGetPrivatizeData();
-    on Locales[0] do
-      _newPrivatizedClassHelp(value, value, n, hereID, privatizeData);
+    on Locales[0] {
+      const pid = chpl_privatization_newPid();
+      _newPrivatizedClassHelp(value, value, pid, hereID, privatizeData);
+      n = pid;
+    }
 
     proc _newPrivatizedClassHelp(parentValue, originalValue, n, hereID, privatizeData) {
       var newValue = originalValue;
@@ -263,6 +266,10 @@ module ChapelArray {
 
     on Locales[0] {
       _freePrivatizedClassHelp(pid, original);
+
+      // Every locale has cleared its entry, so the pid can be reused
+      extern proc chpl_privatization_freePid(pid:int);
+      chpl_privatization_freePid(pid);
     }
 
     proc _freePrivatizedClassHelp(pid, original) {
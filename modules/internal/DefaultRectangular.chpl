@@ -23,6 +23,9 @@ module DefaultRectangular {
   config const dataParTasksPerLocale = 0;
   config const dataParIgnoreRunningTasks = false;
   config const dataParMinGranularity: int = 1;
+  // bulk copies between local arrays of at least this many bytes are
+  // split across tasks
+  config const parallelBulkCopyMinBytes: int = 4 * 1024 * 1024;
 
   if dataParTasksPerLocale<0 then halt("dataParTasksPerLocale must be >= 0");
   if dataParMinGranularity<=0 then halt("dataParMinGranularity must be > 0");
@@ -1867,6 +1870,17 @@ module DefaultRectangular {
     // compilation does not work right now.  The calls to chpl_comm_get
     // and chpl_comm_put should be changed once that is fixed.
     if Adata.locale.id==here.id {
+      if Bdata.locale.id==here.id {
+        const numTasks = _localBulkCopyNumTasks(len, A.eltType);
+        if numTasks > 1 {
+          if debugDefaultDistBulkTransfer then
+            chpl_debug_writeln("\tlocal copy using ", numTasks, " tasks");
+          forall chunk in _localBulkCopyChunks(len:int, numTasks) do
+            __primitive("chpl_comm_array_get", Adata[chunk.low], here.id,
+                        Bdata[chunk.low], chunk.size:size_t);
+          return;
+        }
+      }
       if debugDefaultDistBulkTransfer then
         chpl_debug_writeln("\tlocal get() from ", B.locale.id);
       __primitive("chpl_comm_array_get", Adata[0], Bdata.locale.id, Bdata[0], len);
@@ -1881,6 +1895,63 @@ module DefaultRectangular {
     }
   }
 
+  //
+  // The number of tasks to use for a bulk copy of 'numElems' elements
+  // between two arrays on this locale.  Small copies, and copies made
+  // while serial, are done by the calling task.
+  //
+  private proc _localBulkCopyNumTasks(numElems, type eltType): int {
+    pragma "fn synchronization free"
+    extern proc sizeof(type x): int;
+
+    if __primitive("task_get_serial") then
+      return 1;
+    if numElems:int * sizeof(eltType) < parallelBulkCopyMinBytes then
+      return 1;
+    return _computeNumChunks(numElems:int);
+  }
+
+  //
+  // Divide 0..#numElems among 'numTasks' tasks for a parallel local bulk
+  // copy.  When the locale model has sublocales the range is first split
+  // evenly across them, as the data parallel iterators above do, so that
+  // each piece tends to be copied from the sublocale that first touched it.
+  //
+  private iter _localBulkCopyChunks(numElems: int, numTasks: int) {
+    yield 0..#numElems;
+  }
+
+  private iter _localBulkCopyChunks(param tag: iterKind,
+                                    numElems: int, numTasks: int)
+    where tag == iterKind.standalone {
+
+    const numChunks = min(numTasks, numElems);
+    const numSublocs = here.getChildCount();
+
+    if localeModelHasSublocales && numSublocs > 1 && numChunks > 1 {
+      const numSublocTasks = min(numSublocs, numChunks);
+      coforall subloc in 0..#numSublocTasks {
+        local do on here.getChild(subloc) {
+          const (lo, hi) = _computeBlock(numElems, numSublocTasks, subloc,
+                                         numElems-1);
+          const numTasksHere = (if subloc < numChunks % numSublocTasks
+                                then numChunks / numSublocTasks + 1
+                                else numChunks / numSublocTasks);
+          coforall task in 0..#numTasksHere {
+            const (taskLo, taskHi) = _computeBlock(hi-lo+1, numTasksHere,
+                                                   task, hi, lo, lo);
+            yield taskLo..taskHi;
+          }
+        }
+      }
+    } else {
+      coforall task in 0..#numChunks {
+        const (lo, hi) = _computeBlock(numElems, numChunks, task, numElems-1);
+        yield lo..hi;
+      }
+    }
+  }
+
   /*
   For more details, see: http://upc.lbl.gov/publications/upc_memcpy.pdf
     'Proposal for Extending the UPC Memory Copy Library Functions and
@@ -2066,6 +2137,44 @@ module DefaultRectangular {
     if dest.locale.id == here.id {
       const srclocale = src.locale.id : int(32);
 
+      if srclocale == here.id {
+        var numElems = 1:size_t;
+        for c in count do numElems *= c;
+
+        // Split the outermost level of the transfer across tasks
+        const numOuter = count[stridelevels+1]:int;
+        const numTasks = min(_localBulkCopyNumTasks(numElems, A.eltType),
+                             numOuter);
+        if numTasks > 1 {
+          if debugDefaultDistBulkTransfer {
+            chpl_debug_writeln("BulkTransferStride: local copy using ",
+                               numTasks, " tasks");
+          }
+
+          const (dstOuter, srcOuter) =
+            if stridelevels == 0 then (1, 1)
+            else (dstStride[stridelevels]:int, srcStride[stridelevels]:int);
+
+          forall chunk in _localBulkCopyChunks(numOuter, numTasks) {
+            const chunkcnt = _ddata_allocate(size_t, stridelevels+1);
+            for i in 0..stridelevels do chunkcnt[i] = cnt[i];
+            chunkcnt[stridelevels] = chunk.size:size_t;
+
+            __primitive("chpl_comm_get_strd",
+                        dest[AO + (chunk.low * dstOuter):AO.type],
+                        dststr[0],
+                        srclocale,
+                        src[BO + (chunk.low * srcOuter):BO.type],
+                        srcstr[0],
+                        chunkcnt[0],
+                        stridelevels);
+
+            _ddata_free(chunkcnt, stridelevels+1);
+          }
+          return;
+        }
+      }
+
       if debugBulkTransfer {
         chpl_debug_writeln("BulkTransferStride: On LHS - GET from ", srclocale);
       }
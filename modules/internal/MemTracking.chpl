@@ -30,12 +30,17 @@ module MemTracking
     memLeaks: bool = false,
     memMax: uint = 0,
     memThreshold: uint = 0,
-    memLog: string;
+    memLog: string,
+    memProfileRate: uint = 0;
 
   pragma "no auto destroy"
   config const
     memLeaksLog: string;
 
+  pragma "no auto destroy"
+  config const
+    memProfileLog: string;
+
   /* Causes the contents of the memory tracking array to be printed at the end
      of the program.
      Entries remaining in the memory tracking array represent leaked memory,
@@ -55,7 +60,8 @@ module MemTracking
 
   // Safely cast to size_t instances of memMax and memThreshold.
   const cMemMax = memMax.safeCast(size_t),
-    cMemThreshold = memThreshold.safeCast(size_t);
+    cMemThreshold = memThreshold.safeCast(size_t),
+    cMemProfileRate = memProfileRate.safeCast(size_t);
 
   //
   // This communicates the settings of the various memory tracking
@@ -78,13 +84,16 @@ module MemTracking
                                          ref ret_memMax: size_t,
                                          ref ret_memThreshold: size_t,
                                          ref ret_memLog: c_string,
-                                         ref ret_memLeaksLog: c_string) {
+                                         ref ret_memLeaksLog: c_string,
+                                         ref ret_memProfileRate: size_t,
+                                         ref ret_memProfileLog: c_string) {
     ret_memTrack = memTrack;
     ret_memStats = memStats;
     ret_memLeaksByType = memLeaksByType;
     ret_memLeaks = memLeaks;
     ret_memMax = cMemMax;
     ret_memThreshold = cMemThreshold;
+    ret_memProfileRate = cMemProfileRate;
 
     if (here.id != 0) {
       if memLeaksByDesc.length != 0 {
@@ -114,10 +123,20 @@ module MemTracking
         ret_memLeaksLog = nil;
       }
 
+      if memProfileLog.length != 0 {
+        var local_memProfileLog = memProfileLog;
+        // Intentionally leak the string to persist the underlying buffer
+        local_memProfileLog.isowned = false;
+        ret_memProfileLog = local_memProfileLog.c_str();
+      } else {
+        ret_memProfileLog = nil;
+      }
+
      } else {
       ret_memLeaksByDesc = memLeaksByDesc.c_str();
       ret_memLog = memLog.c_str();
       ret_memLeaksLog = memLeaksLog.c_str();
+      ret_memProfileLog = memProfileLog.c_str();
     }
   }
 }
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+  This module provides support for reporting and counting the activity
+  of the remote data cache, which is enabled with the ``--cache-remote``
+  compiler option.  It is meant to help decide whether a given program
+  benefits from the cache.  Its interface mirrors that of the
+  :mod:`CommDiagnostics` module.
+
+  **On-the-fly Reporting**
+
+  On-the-fly reporting across all locales is done like this::
+
+    startVerboseCache();
+    // between start/stop calls, report cache GETs made on any locale
+    stopVerboseCache();
+
+  and for just the calling locale with :proc:`startVerboseCacheHere`
+  and :proc:`stopVerboseCacheHere`.  A line is written to ``stdout``
+  for each remote GET that goes through the cache, giving the file name
+  and line number of the access and whether it hit or missed in the
+  cache, and for each GET or PUT that is too large to be cached and so
+  bypasses it.  Summarizing this output by file and line shows which
+  accesses in a program actually benefit from the cache.
+
+  **Counting Cache Events**
+
+  Counting across all locales is done like this::
+
+    // (optional) if we counted previously, reset the counters to zero
+    resetCacheDiagnostics();
+    startCacheDiagnostics();
+    // between start/stop calls, count cache events on any locale
+    stopCacheDiagnostics();
+    // retrieve the counts and report the results
+    writeln(getCacheDiagnostics());
+
+  As with :mod:`CommDiagnostics`, there are ``Here`` versions of these
+  procedures that only affect the calling locale.  In addition, while
+  counting is on each task keeps its own counts of the cache events it
+  caused, which it can retrieve with :proc:`getTaskCacheDiagnostics`
+  and clear with :proc:`resetTaskCacheDiagnostics`.  A task's counts
+  start at zero when the task is created.
+
+  Comparing the ``hits`` and ``misses`` counts against the ``get``
+  count from :mod:`CommDiagnostics` for a run without the cache gives a
+  quick measure of how much communication the cache is saving.
+
+  If the program was not compiled with ``--cache-remote``, or the
+  communication layer in use has no remote data cache, all of the
+  counts stay zero.
+ */
+module CacheDiagnostics
+{
+  /* Aggregated remote data cache event counts.  This record type is
+     defined in the same way by both the runtime and this module.  This
+     definition duplicates the one in the runtime.
+   */
+  extern record chpl_cacheDiagnostics {
+    /*
+      remote GETs satisfied entirely from the cache
+     */
+    var hits: uint(64);
+    /*
+      remote GETs for which at least some data had to be fetched
+     */
+    var misses: uint(64);
+    /*
+      hits on data that was brought into the cache by a prefetch or
+      readahead; each of these is also counted in `hits`
+     */
+    var prefetch_hits: uint(64);
+    /*
+      sequential readaheads started by the cache
+     */
+    var readaheads: uint(64);
+    /*
+      prefetches started for GETs predicted by a constant-stride
+      access stream
+     */
+    var stride_prefetches: uint(64);
+    /*
+      cache pages evicted to make room for other data
+     */
+    var evictions: uint(64);
+    /*
+      non-blocking PUTs started to write buffered data back to the
+      remote locale
+     */
+    var write_behind_flushes: uint(64);
+    /*
+      bytes of remote GETs that were copied out of the cache instead of
+      being communicated
+     */
+    var bytes_saved: uint(64);
+
+    proc writeThis(c) throws {
+      use Reflection;
+
+      var first = true;
+      c <~> "(";
+      for param i in 1..numFields(chpl_cacheDiagnostics) {
+        param name = getFieldName(this.type, i);
+        const val = getField(this, i);
+        if val != 0 {
+          if first then first = false; else c <~> ", ";
+          c <~> name <~> " = " <~> val;
+        }
+      }
+      if first then c <~> "<no cache activity>";
+      c <~> ")";
+    }
+  };
+
+  /*
+    The Chapel record type inherits the runtime definition of it.
+   */
+  type cacheDiagnostics = chpl_cacheDiagnostics;
+
+  private extern proc chpl_cache_startVerbose();
+
+  private extern proc chpl_cache_stopVerbose();
+
+  private extern proc chpl_cache_startVerboseHere();
+
+  private extern proc chpl_cache_stopVerboseHere();
+
+  private extern proc chpl_cache_startDiagnostics();
+
+  private extern proc chpl_cache_stopDiagnostics();
+
+  private extern proc chpl_cache_startDiagnosticsHere();
+
+  private extern proc chpl_cache_stopDiagnosticsHere();
+
+  private extern proc chpl_cache_resetDiagnosticsHere();
+
+  private extern proc chpl_cache_getDiagnosticsHere(out cd: cacheDiagnostics);
+
+  private extern proc chpl_cache_resetTaskDiagnostics();
+
+  private extern proc chpl_cache_getTaskDiagnostics(out cd: cacheDiagnostics);
+
+  /*
+    Start on-the-fly reporting of cache activity on any locale.
+   */
+  proc startVerboseCache() { chpl_cache_startVerbose(); }
+
+  /*
+    Stop on-the-fly reporting of cache activity on any locale.
+   */
+  proc stopVerboseCache() { chpl_cache_stopVerbose(); }
+
+  /*
+    Start on-the-fly reporting of cache activity on this locale.
+   */
+  proc startVerboseCacheHere() { chpl_cache_startVerboseHere(); }
+
+  /*
+    Stop on-the-fly reporting of cache activity on this locale.
+   */
+  proc stopVerboseCacheHere() { chpl_cache_stopVerboseHere(); }
+
+  /*
+    Start counting cache events across the whole program.
+   */
+  proc startCacheDiagnostics() { chpl_cache_startDiagnostics(); }
+
+  /*
+    Stop counting cache events across the whole program.
+   */
+  proc stopCacheDiagnostics() { chpl_cache_stopDiagnostics(); }
+
+  /*
+    Start counting cache events on this locale.
+   */
+  proc startCacheDiagnosticsHere() { chpl_cache_startDiagnosticsHere(); }
+
+  /*
+    Stop counting cache events on this locale.
+   */
+  proc stopCacheDiagnosticsHere() { chpl_cache_stopDiagnosticsHere(); }
+
+  /*
+    Reset aggregate cache event counts across the whole program.
+   */
+  proc resetCacheDiagnostics() {
+    for loc in Locales do on loc do
+      resetCacheDiagnosticsHere();
+  }
+
+  /*
+    Reset aggregate cache event counts on the calling locale.
+   */
+  inline proc resetCacheDiagnosticsHere() {
+    chpl_cache_resetDiagnosticsHere();
+  }
+
+  /*
+    Retrieve aggregate cache event counts for the whole program.
+
+    :returns: array of counts of cache events on each locale
+    :rtype: `[LocaleSpace] cacheDiagnostics`
+   */
+  proc getCacheDiagnostics() {
+    var D: [LocaleSpace] cacheDiagnostics;
+    for loc in Locales do on loc {
+      D(loc.id) = getCacheDiagnosticsHere();
+    }
+    return D;
+  }
+
+  /*
+    Retrieve aggregate cache event counts for this locale.
+
+    :returns: counts of cache events on this locale
+    :rtype: `cacheDiagnostics`
+   */
+  proc getCacheDiagnosticsHere() {
+    var cd: cacheDiagnostics;
+    chpl_cache_getDiagnosticsHere(cd);
+    return cd;
+  }
+
+  /*
+    Reset the calling task's cache event counts.
+   */
+  inline proc resetTaskCacheDiagnostics() {
+    chpl_cache_resetTaskDiagnostics();
+  }
+
+  /*
+    Retrieve the cache event counts for the calling task.
+
+    :returns: counts of cache events caused by this task
+    :rtype: `cacheDiagnostics`
+   */
+  proc getTaskCacheDiagnostics() {
+    var cd: cacheDiagnostics;
+    chpl_cache_getTaskDiagnostics(cd);
+    return cd;
+  }
+}
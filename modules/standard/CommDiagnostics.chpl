@@ -231,6 +231,12 @@ module CommDiagnostics
       non-blocking remote executions
      */
     var execute_on_nb: uint(64);
+    /*
+      messages carrying batches of coalesced non-blocking remote
+      executions; each of these executions is also counted in
+      `execute_on_nb`
+     */
+    var execute_on_nb_batch: uint(64);
 
     proc writeThis(c) throws {
       use Reflection;
@@ -680,6 +680,8 @@ pragma "no doc"
 extern const QIO_HINT_NOREUSE:c_int;
 pragma "no doc"
 extern const QIO_HINT_OWNED:c_int;
+pragma "no doc"
+extern const QIO_HINT_ASYNC:c_int;
 
 /*  IOHINT_NONE means normal operation, nothing special
     to hint. Expect to use NONE most of the time.
@@ -708,6 +710,13 @@ const IOHINT_CACHED = QIO_HINT_CACHED;
  */
 const IOHINT_PARALLEL = QIO_HINT_PARALLEL;
 
+/*  IOHINT_ASYNC means that a channel reading or writing
+    sequentially should do its file I/O in the background,
+    reading ahead or writing behind a few buffers at a time.
+    It has no effect on channels that both read and write.
+ */
+const IOHINT_ASYNC = QIO_HINT_ASYNC;
+
 pragma "no doc"
 extern type qio_file_ptr_t;
 private extern const QIO_FILE_PTR_NULL:qio_file_ptr_t;
@@ -1079,6 +1088,7 @@ private extern proc qio_channel_write_byte(threadsafe:c_int, ch:qio_channel_ptr_
 private extern proc qio_channel_offset_unlocked(ch:qio_channel_ptr_t):int(64);
 private extern proc qio_channel_advance(threadsafe:c_int, ch:qio_channel_ptr_t, nbytes:int(64)):syserr;
 private extern proc qio_channel_advance_past_byte(threadsafe:c_int, ch:qio_channel_ptr_t, byte:c_int):syserr;
+private extern proc qio_channel_peek_through_byte(threadsafe:c_int, ch:qio_channel_ptr_t, byte:c_int, ref scratch:c_ptr(uint(8)), ref scratch_size:int(64), ref ptr_out:c_ptr(uint(8)), ref len_out:int(64)):syserr;
 
 private extern proc qio_channel_mark(threadsafe:c_int, ch:qio_channel_ptr_t):syserr;
 private extern proc qio_channel_revert_unlocked(ch:qio_channel_ptr_t);
@@ -1333,6 +1343,12 @@ The following :type:`iohints` constants are provided:
     cached in memory, possibly all at once.
   * :const:`IOHINT_PARALLEL` suggests to expect many channels
     working with this file in parallel.
+  * :const:`IOHINT_ASYNC` suggests that reading or writing channels
+    overlap their file I/O with computation by reading ahead or
+    writing behind in the background. The number of buffers in flight
+    per channel and the number of background I/O threads can be set
+    with the ``CHPL_RT_IO_ASYNC_DEPTH`` (default 4) and
+    ``CHPL_RT_IO_ASYNC_THREADS`` (default 2) environment variables.
 
 
 Other hints might be added in the future.
@@ -2666,6 +2682,197 @@ proc file.lines(param locking:bool = true, start:int(64) = 0, end:int(64) = max(
   return ret;
 }
 
+/* Iterate over the lines in a file, in serial or in parallel.
+
+   Like :proc:`file.lines`, a ``for`` loop over the returned object yields
+   the lines in order.  A ``forall`` loop over it splits the region of the
+   file being read into chunks, one per task, with each chunk boundary
+   moved forward to just after a newline so that no line is split between
+   tasks.  Each task reads its chunk with its own channel, and there is no
+   ordering between lines read by different tasks.  The loop body runs on
+   the locale where the file was opened.  Zippered loops over the
+   returned object are not yet supported, since its iterators throw.
+
+   :arg distributed: if `true`, a ``forall`` loop spreads the chunks
+                     across locales, placing each one on a locale
+                     returned by :proc:`file.localesForRegion` for it.
+                     The file is reopened by path on each locale used,
+                     so it must be accessible at the same path on all
+                     of them, as with a shared file system.  Defaults
+                     to `false`.
+
+   :returns: an object which yields strings read from the file
+
+   :throws SystemError: Thrown if the file is not open.  Errors reading
+                        the file are thrown by the loop over the
+                        returned object.
+ */
+proc file.parallelLines(start:int(64) = 0, end:int(64) = max(int(64)),
+                        hints:iohints = IOHINT_NONE,
+                        in local_style:iostyle = this._style,
+                        distributed:bool = false) throws {
+  local_style.string_format = QIO_STRING_FORMAT_TOEND;
+  local_style.string_end = 0x0a; // '\n'
+
+  on this.home {
+    try this.checkAssumingLocal();
+  }
+
+  return new _fileLines(this, start, end, hints, local_style, distributed);
+}
+
+// Parallel line iteration divides the file into chunks of at least this
+// many bytes, since each task opens its own channel.
+private param _linesMinChunkBytes = 64*1024;
+
+/* What :proc:`file.parallelLines` returns.  Each iteration over it opens
+   its own channels, one per task when it runs in parallel.
+ */
+pragma "no doc"
+record _fileLines {
+  var f:file;
+  var start:int(64);
+  var end:int(64);
+  var hints:iohints;
+  var style:iostyle;
+  var distributed:bool;
+
+  iter these() throws {
+    const (lo, hi) = try _region();
+    for line in _linesIn(f, lo, hi, lo, hi) do
+      yield line;
+  }
+
+  iter these(param tag:iterKind) throws where tag == iterKind.standalone {
+    const (lo, hi) = try _region();
+    const chunks = _chunks(lo, hi);
+
+    if chunks.size == 1 {
+      on f.home do
+        for line in _linesIn(f, lo, hi, lo, hi) do
+          yield line;
+    } else if !distributed || numLocales == 1 {
+      on f.home do
+        coforall chunk in chunks do
+          for line in _linesIn(f, chunk.low, chunk.high+1, lo, hi) do
+            yield line;
+    } else {
+      const path = f.tryGetPath();
+      coforall chunk in chunks {
+        const loc = try _chunkLocale(chunk);
+        on loc {
+          const fl = try _fileHere(path);
+          for line in _linesIn(fl, chunk.low, chunk.high+1, lo, hi) do
+            yield line;
+        }
+      }
+    }
+  }
+
+  iter these(param tag:iterKind) throws where tag == iterKind.leader {
+    const (lo, hi) = try _region();
+    const chunks = _chunks(lo, hi);
+
+    if chunks.size == 1 {
+      yield (lo..hi-1,);
+    } else if !distributed || numLocales == 1 {
+      on f.home do
+        coforall chunk in chunks do
+          yield (chunk,);
+    } else {
+      coforall chunk in chunks {
+        const loc = try _chunkLocale(chunk);
+        on loc do
+          yield (chunk,);
+      }
+    }
+  }
+
+  iter these(param tag:iterKind, followThis) throws
+    where tag == iterKind.follower {
+    const (lo, hi) = try _region();
+    const chunk = followThis(1);
+    const fl = try _fileHere(f.tryGetPath());
+    for line in _linesIn(fl, chunk.low, chunk.high+1, lo, hi) do
+      yield line;
+  }
+
+  // The region of the file to read, with the end clamped to its length
+  proc _region() throws {
+    const len = try f.length();
+    return (start, min(end, max(start, len)));
+  }
+
+  // Divide lo..hi-1 into roughly equal chunks, before newline alignment
+  proc _chunks(lo:int(64), hi:int(64)) {
+    const tasksPerLocale = if dataParTasksPerLocale > 0
+                           then dataParTasksPerLocale
+                           else here.maxTaskPar;
+    const numTasks = if distributed then tasksPerLocale * numLocales
+                                    else tasksPerLocale;
+    const bySize = ((hi - lo) / _linesMinChunkBytes):int;
+    const numChunks = max(1, min(numTasks, bySize));
+    var chunks: [0..#numChunks] range(int(64));
+    for i in 0..#numChunks {
+      const clo = lo + (hi - lo) * i / numChunks;
+      const chi = lo + (hi - lo) * (i + 1) / numChunks;
+      chunks[i] = clo..chi-1;
+    }
+    return chunks;
+  }
+
+  // Pick a locale for working with chunk, spreading the chunks over the
+  // locales that are equally good for it
+  proc _chunkLocale(chunk:range(int(64))) throws {
+    const locs = try f.localesForRegion(chunk.low, chunk.high+1);
+    const which = (chunk.low / max(1, chunk.size)) % locs.size;
+    var i = 0;
+    for loc in locs {
+      if i == which then return loc;
+      i += 1;
+    }
+    return f.home;
+  }
+
+  // A handle for the file that is local to here
+  proc _fileHere(path:string) throws {
+    if here == f.home || path == "unknown" then return f;
+    return try open(path, iomode.r, hints=hints);
+  }
+
+  // The first line start at or after pos within lo..hi-1; lines belong
+  // to the chunk in which they start
+  proc _lineStartAfter(fl:file, pos:int(64), lo:int(64), hi:int(64)) throws {
+    if pos <= lo then return lo;
+    if pos >= hi then return hi;
+    var r = try fl.reader(locking=false, start=pos-1, end=hi, hints=hints,
+                          style=style);
+    try {
+      r.advancePastByte(0x0a);
+    } catch e:EOFError {
+      return hi;
+    }
+    return r.offset();
+  }
+
+  // Yield the lines that start in clo..chi-1, given the whole region
+  // being read is lo..hi-1
+  iter _linesIn(fl:file, clo:int(64), chi:int(64), lo:int(64), hi:int(64)) throws {
+    const s = try _lineStartAfter(fl, clo, lo, hi);
+    const e = try _lineStartAfter(fl, chi, lo, hi);
+    if s < e {
+      var r = try fl.reader(locking=false, start=s, end=e, hints=hints,
+                            style=style);
+      var line:string;
+      var got = try r.read(line);
+      while got {
+        yield line;
+        got = try r.read(line);
+      }
+    }
+  }
+}
+
 /*
    Create a :record:`channel` that supports writing to a file. See
    :ref:`about-io-overview`.
@@ -3422,6 +3629,58 @@ iter channel.lines() {
 }
 
 
+/*
+  Iterate over the records in a channel that end in a delimiter byte,
+  such as the lines ending in ``\n``, without copying them.  Each
+  record is yielded as a :type:`~Bytes.bytes` that borrows its
+  contents from the channel's buffer, including the delimiter (the
+  last record may lack it if the channel ends without one).  No heap
+  allocation is done per record, except when a record straddles two
+  parts of the channel's buffer, in which case it is gathered into
+  scratch space that is reused for later records.
+
+  The channel lock will be held while iterating, and the loop body
+  runs on the locale where the channel was created.
+
+  .. warning::
+
+    A yielded record is only valid until the loop moves on to the next
+    one.  Copy it, for example with ``createBytesWithNewBuffer``, to
+    keep it for longer.  Do not use the channel in the loop body.
+
+  :arg delimiter: the byte that ends each record.  Defaults to ``\n``.
+  :yields: borrowed views of the records in the channel
+
+  :throws SystemError: Thrown if the channel could not be read.
+ */
+iter channel.lineViews(delimiter:uint(8) = 0x0a):bytes throws {
+  if writing then compilerError("lineViews on write-only channel");
+
+  on this.home {
+    try this.lock(); defer { this.unlock(); }
+
+    var scratch: c_ptr(uint(8)) = nil;
+    var scratchSize: int(64) = 0;
+    defer { c_free(scratch); }
+
+    while true {
+      var ptr: c_ptr(uint(8));
+      var len: int(64);
+      var err = qio_channel_peek_through_byte(false, _channel_internal,
+                                              delimiter, scratch,
+                                              scratchSize, ptr, len);
+      if err == EEOF then break;
+      if err then try this._ch_ioerror(err, "in channel.lineViews()");
+
+      yield createBytesWithBorrowedBuffer(ptr, len, len);
+
+      err = qio_channel_advance(false, _channel_internal, len);
+      if err then try this._ch_ioerror(err, "in channel.lineViews()");
+    }
+  }
+}
+
+
 pragma "no doc"
 proc _can_stringify_direct(t) param : bool {
   if (t.type == string ||
@@ -4390,7 +4649,7 @@ proc file.localesForRegion(start:int(64), end:int(64)) {
 
   proc findloc(loc:string, locs:c_ptr(c_string), end:int) {
     for i in 0..end-1 {
-      if (loc == locs[i]) then
+      if loc.c_str() == locs[i] then
         return true;
     }
     return false;
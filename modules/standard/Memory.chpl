@@ -86,6 +86,33 @@
     In multilocale executions each top-level locale produces output
     to its own file, with a dot ('.') and the locale ID appended to
     this path.
+
+  The following two config variables control allocation profiling.
+  This is separate from memory tracking and does not enable it, and
+  the procedures in this module do not report on it.
+
+  ``memProfileRate``: `uint`:
+    If the value is greater than 0 (zero), sample allocations at an
+    average rate of one per this many bytes allocated, and write an
+    allocation profile when the program terminates normally.  Each
+    sample is attributed to the source location and kind of the
+    allocation, and is scaled up to estimate the total bytes
+    allocated there.  The overhead is far lower than that of memory
+    tracking, so this can be used on long production runs; a rate
+    around 512 KiB is a reasonable starting point.  The profile is
+    an estimate, and sites that allocate much less than the rate in
+    total may not appear in it.
+
+  ``memProfileLog``: `string`:
+    The profile is written to two files whose names are this path
+    with ``.alloc`` and ``.live`` appended.  The default path is
+    ``memprofile``.  In multilocale executions the locale ID and a
+    dot are inserted before the suffix.  The ``.alloc`` file gives
+    the estimated bytes allocated over the whole run at each site,
+    and the ``.live`` file the estimated bytes still allocated at
+    the end.  Each line has the form ``file:line;description bytes``,
+    which is the "folded stacks" format read by flame graph tools
+    such as ``flamegraph.pl``.
  */
 module Memory {
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_cache_diags_h_
+#define _chpl_cache_diags_h_
+
+//
+// Remote data cache diagnostics.
+//
+// This is kept separate from chpl-cache.h and does not depend on any
+// other runtime header, because the per-task counters are embedded in
+// the cache's task private data, which is declared very early on.
+//
+
+#include <stdint.h>
+
+extern int chpl_verbose_cache;     // set via startVerboseCache
+extern int chpl_cache_diagnostics; // set via startCacheDiagnostics
+
+#define CHPL_CACHE_DIAGS_VARS_ALL(MACRO) \
+  MACRO(hits) \
+  MACRO(misses) \
+  MACRO(prefetch_hits) \
+  MACRO(readaheads) \
+  MACRO(stride_prefetches) \
+  MACRO(evictions) \
+  MACRO(write_behind_flushes) \
+  MACRO(bytes_saved)
+
+typedef struct _chpl_cacheDiagnostics {
+#define _CACHE_DIAGS_DECL(cdv) uint64_t cdv;
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_DECL)
+#undef _CACHE_DIAGS_DECL
+} chpl_cacheDiagnostics;
+
+void chpl_cache_startVerbose(void);
+void chpl_cache_stopVerbose(void);
+void chpl_cache_startVerboseHere(void);
+void chpl_cache_stopVerboseHere(void);
+
+void chpl_cache_startDiagnostics(void);
+void chpl_cache_stopDiagnostics(void);
+void chpl_cache_startDiagnosticsHere(void);
+void chpl_cache_stopDiagnosticsHere(void);
+void chpl_cache_resetDiagnosticsHere(void);
+void chpl_cache_getDiagnosticsHere(chpl_cacheDiagnostics *cd);
+void chpl_cache_resetTaskDiagnostics(void);
+void chpl_cache_getTaskDiagnostics(chpl_cacheDiagnostics *cd);
+
+#endif
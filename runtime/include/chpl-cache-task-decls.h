@@ -20,9 +20,27 @@
 #ifndef _chpl_cache_task_decls_h_
 #define _chpl_cache_task_decls_h_
 
+#include "chpl-cache-diags.h"
+
+// How many constant-stride GET streams each task tracks for prefetching
+#define CHPL_CACHE_STREAMS_PER_TASK 4
+
+// A stream of remote GETs to one node, separated by a constant stride
+typedef struct {
+  uintptr_t last_raddr; // address of the last GET; 0 if the slot is unused
+  intptr_t stride;      // distance from the GET before that one
+  int32_t node;
+  int8_t confidence;    // how many GETs in a row matched the stride
+  int8_t distance;      // how many strides ahead to prefetch
+  int8_t ahead;         // how many strides ahead have been prefetched
+} chpl_cache_stream_t;
+
 // This is the type of the task private data used by the cache
 typedef struct {
   int64_t last_acquire; // cache acquire barrier sets this
+  chpl_cacheDiagnostics diags; // this task's cache event counts
+  chpl_cache_stream_t streams[CHPL_CACHE_STREAMS_PER_TASK];
+  int next_stream; // stream slot to replace next
 } chpl_cache_taskPrvData_t;
 
 #endif
@@ -46,7 +46,8 @@ extern int chpl_comm_diags_print_unstable;
   MACRO(amo) \
   MACRO(execute_on) \
   MACRO(execute_on_fast) \
-  MACRO(execute_on_nb)
+  MACRO(execute_on_nb) \
+  MACRO(execute_on_nb_batch)
 
 typedef struct _chpl_commDiagnostics {
 #define _COMM_DIAGS_DECL(cdv) uint64_t cdv;
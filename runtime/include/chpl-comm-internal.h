@@ -48,7 +48,9 @@ extern size_t chpl_rt_priv_bcast_lens[];
   MACRO(chpl_verbose_comm)                   \
   MACRO(chpl_comm_diagnostics)               \
   MACRO(chpl_comm_diags_print_unstable)      \
-  MACRO(chpl_verbose_mem)
+  MACRO(chpl_verbose_mem)                    \
+  MACRO(chpl_verbose_cache)                  \
+  MACRO(chpl_cache_diagnostics)
 
 #define _RT_PRV_BCAST_M(sym)  chpl_rt_prv_tab_ ## sym ## _idx,
 typedef enum {
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_mem_profile_H_
+#define _chpl_mem_profile_H_
+
+#ifndef LAUNCHER
+
+#include "chpltypes.h"  // for c_string
+#include "chpl-mem-desc.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Sampling allocation profiler.
+//
+// When enabled via the memProfileRate config const, roughly one
+// allocation per memProfileRate bytes is sampled, with the distance
+// between samples drawn from an exponential distribution so that every
+// allocated byte is equally likely to be sampled.  Samples are
+// attributed to the Chapel source location and memory descriptor of
+// the allocation, and are scaled up to estimate the total bytes
+// allocated at each site and the bytes still live at each site.  At
+// exit these are written as profiles in the "folded stacks" format
+// understood by flamegraph.pl and similar tools.
+//
+
+// Allocation profiling activated?
+extern int chpl_memProfile;
+
+void chpl_memprofile_init(size_t rate, c_string log);
+void chpl_memprofile_report(void);
+
+void chpl_memprofile_malloc(void* memAlloc, size_t size,
+                            chpl_mem_descInt_t description,
+                            int32_t lineno, int32_t filename);
+void chpl_memprofile_free(void* memAlloc);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
+
+#endif // LAUNCHER
+
+#endif // _chpl_mem_profile_H_
@@ -21,6 +21,7 @@
 #define _chpl_privatization_h_
 #ifndef LAUNCHER
 #include <stdint.h>
+#include "chpl-bitops.h"
 #include "chpltypes.h"
 
 void chpl_privatization_init(void);
@@ -31,17 +32,48 @@ typedef struct chpl_privateObject_s {
   void* obj;
 } chpl_privateObject_t;
 
-// This is a dynamically-allocated array of chpl_privateObject_t.
-extern chpl_privateObject_t* chpl_privateObjects;
+//
+// Privatized objects are kept in a table split into segments that
+// never move once allocated, so it can be read without locking while
+// other tasks register new objects.  Segment 0 holds pids
+// 0..CHPL_PRIVATIZATION_SEG0_SIZE-1 and each later segment is twice
+// the size of the one before it.
+//
+#define CHPL_PRIVATIZATION_SEG0_LOG2 6
+#define CHPL_PRIVATIZATION_SEG0_SIZE (1 << CHPL_PRIVATIZATION_SEG0_LOG2)
+#define CHPL_PRIVATIZATION_MAX_SEGS (64 - CHPL_PRIVATIZATION_SEG0_LOG2)
 
-// Compiler generates accesses like chpl_privateObjects[i];
-// see chpl_getPrivatizedCopy.
-// This allows TBAA information for chpl_privateObjects to be used.
+extern chpl_privateObject_t*
+       chpl_privateObjectSegs[CHPL_PRIVATIZATION_MAX_SEGS];
+
+// Compiler generates calls to this through chpl_getPrivatizedCopy.
 // At the very least, inlining it would be important for performance.
+static inline
+void* chpl_getPrivatizedClass(int64_t pid) {
+  const uint64_t j = (uint64_t) pid + CHPL_PRIVATIZATION_SEG0_SIZE;
+  const int msb = 63 - (int) chpl_bitops_clz_64(j);
+  return chpl_privateObjectSegs[msb - CHPL_PRIVATIZATION_SEG0_LOG2]
+                               [j - ((uint64_t) 1 << msb)].obj;
+}
 
 void chpl_clearPrivatizedClass(int64_t);
 
+//
+// Pids are handed out and recycled by locale 0.  A pid is returned
+// with chpl_privatization_freePid() only after every locale has
+// cleared its entry for it, so it can be reused right away.
+//
+int64_t chpl_privatization_newPid(void);
+void chpl_privatization_freePid(int64_t);
+
+// Used to check for leaks of privatized classes
 int64_t chpl_numPrivatizedClasses(void);
 
+// Number of table entries allocated on this locale
+int64_t chpl_privatizedClassesCapacity(void);
+
+// Number of pids handed out again after being freed (locale 0 only)
+int64_t chpl_numPrivatizedPidsReused(void);
+
 #endif // LAUNCHER
 #endif // _chpl_privatization_h_
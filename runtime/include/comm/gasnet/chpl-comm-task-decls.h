@@ -26,6 +26,7 @@
 
 typedef struct {
     chpl_cache_taskPrvData_t cache_data;
+    void* unordered_buff;
 } chpl_comm_taskPrvData_t;
 
 //
@@ -35,6 +35,7 @@
 typedef struct {
   chpl_cache_taskPrvData_t cache_data;
   int numTxnsOut;    // number of transactions outstanding
+  void* amoAggBufs;  // unordered AMO aggregation buffers, if any
 } chpl_comm_taskPrvData_t;
 
 //
@@ -106,12 +107,22 @@ struct chpl_comm_bundleData_AMO_t {
   chpl_comm_amDone_t* pAmDone;  // initiator's 'amDone' flag; NULL means nonblk
 };
 
+//
+// A batch of unordered AMOs.  The AMOs themselves follow the bundle.
+//
+struct chpl_comm_bundleData_AMOBatch_t {
+  struct chpl_comm_bundleData_base_t b;
+  uint16_t count;               // number of AMOs in the batch
+  chpl_comm_amDone_t* pAmDone;  // initiator's 'amDone' flag
+};
+
 typedef union {
   struct chpl_comm_bundleData_base_t b;
   struct chpl_comm_bundleData_execOn_t xo;
   struct chpl_comm_bundleData_execOnLrg_t xol;
   struct chpl_comm_bundleData_RMA_t rma;
   struct chpl_comm_bundleData_AMO_t amo;
+  struct chpl_comm_bundleData_AMOBatch_t amoBatch;
 } chpl_comm_bundleData_t;
 
 // The type of the communication handle.
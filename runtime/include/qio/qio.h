@@ -276,6 +276,11 @@ enum {
   // is opened within the qio implementation.  Otherwise, the user (or system)
   // has to close it.
   QIO_HINT_OWNED        = QIO_HINT_NOFAST<<1,
+
+  // Read ahead or write behind in the background, with a small pool
+  // of I/O threads (see qio_async.h). Only used for pread/pwrite
+  // channels that read or write but not both; otherwise ignored.
+  QIO_HINT_ASYNC        = QIO_HINT_OWNED<<1,
 };
 
 
@@ -352,6 +357,7 @@ char* qio_hints_to_string(qio_hint_t hint)
   if( hint & QIO_HINT_NOREUSE ) strcat(buf, " noreuse");
   if( hint & QIO_HINT_NOFAST ) strcat(buf, " nofast");
   if( hint & QIO_HINT_OWNED ) strcat(buf, " owned");
+  if( hint & QIO_HINT_ASYNC ) strcat(buf, " async");
 
   return qio_strdup(buf);
 }
@@ -702,6 +708,15 @@ typedef struct qio_channel_s {
 
   qbuffer_t buf;
 
+  // With QIO_HINT_ASYNC, the outstanding read-ahead or write-behind
+  // requests, oldest first. Read-ahead requests are contiguous
+  // starting at av_end.
+  struct qio_async_req_s* async_head;
+  struct qio_async_req_s* async_tail;
+  ssize_t async_count;
+  // sticky error from a background write.
+  qioerr async_err;
+
   // For reading/writing bits (ie less than a byte) at a time
   qio_bitbuffer_t bit_buffer;
   void* cached_end_bits; // cause flush before byte I/O
@@ -1202,6 +1217,16 @@ qioerr qio_channel_end_peek_cached(const int threadsafe, qio_channel_t* ch, void
 
 qioerr qio_channel_advance_past_byte(const int threadsafe, qio_channel_t* ch, int byte);
 
+// Find the next occurrence of byte at or after the current position
+// (reading more data if necessary) without advancing the channel.
+// Returns in ptr_out/len_out the bytes from the current position
+// through that byte, or through EOF if it does not occur.  These point
+// into the channel's buffer when they are contiguous there, and are
+// otherwise copied to *scratch, which is grown with qio_realloc as
+// needed.  Either way they are valid until the channel is next used.
+// Returns EEOF if there is no data left.
+qioerr qio_channel_peek_through_byte(const int threadsafe, qio_channel_t* ch, int byte, uint8_t** scratch, int64_t* scratch_size, uint8_t** ptr_out, int64_t* len_out);
+
 qioerr qio_channel_begin_peek_buffer(const int threadsafe, qio_channel_t* ch, int64_t require, int writing, qbuffer_t** buf_out, qbuffer_iter_t* start_out, qbuffer_iter_t* end_out);
 
 qioerr qio_channel_end_peek_buffer(const int threadsafe, qio_channel_t* ch, int64_t advance);
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _QIO_ASYNC_H_
+#define _QIO_ASYNC_H_
+
+#include "sys_basic.h"
+
+#include <inttypes.h>
+#include "qbuffer.h"
+#include "sys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Background pread/pwrite requests, used by channels with QIO_HINT_ASYNC
+// for read-ahead and write-behind. The requests are serviced by a small
+// pool of threads that is started on first use.
+
+// How many requests a channel keeps in flight at once.
+// Overridden by CHPL_RT_IO_ASYNC_DEPTH.
+extern ssize_t qio_async_depth;
+// How many threads service the requests.
+// Overridden by CHPL_RT_IO_ASYNC_THREADS.
+extern ssize_t qio_async_threads;
+
+typedef struct qio_async_req_s {
+  struct qio_async_req_s* next_queued; // next in the pool's queue
+  struct qio_async_req_s* next;        // next in the channel's list
+
+  fd_t fd;
+  int writing;
+  qbytes_t* bytes; // retained by the request
+  int64_t skip;
+  int64_t len;
+  int64_t offset;
+
+  // Set by the pool once the request is done.
+  int64_t num_done;
+  qioerr err;
+  int done;
+} qio_async_req_t;
+
+// Starts reading into (or writing from) len bytes of bytes at skip,
+// at file offset offset. Returns an error if the pool could not be
+// started, in which case the caller should do the I/O itself.
+qioerr qio_async_submit(fd_t fd, int writing, qbytes_t* bytes,
+                        int64_t skip, int64_t len, int64_t offset,
+                        qio_async_req_t** req_out);
+
+// Blocks until the request is done.
+void qio_async_wait(qio_async_req_t* req);
+
+// Frees a request that is done.
+void qio_async_free(qio_async_req_t* req);
+
+// Returns qio_async_depth, but at least 1.
+int64_t qio_async_max_depth(void);
+
+#ifdef __cplusplus
+} // end extern "C"
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// qio_bytescan.h
+//
+// Kernels for scanning runs of bytes in a buffer, used by the
+// formatted reading fast paths.  These use SSE2 or AVX2 when the
+// target supports them and fall back to scalar loops otherwise.
+// (Searching for a single byte is left to memchr, which the C library
+// already vectorizes.)
+#ifndef _QIO_BYTESCAN_H_
+#define _QIO_BYTESCAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Means "no stop byte" to qio_scan_plain_ascii.  Any byte >= 0x80
+// stops the scan anyway.
+#define QIO_SCAN_NO_STOP 0x80
+
+static inline
+int _qio_scan_plain_byte(uint8_t b, uint8_t stop1, uint8_t stop2,
+                         int stop_ctrl)
+{
+  return b < 0x80 && b != stop1 && b != stop2 && !(stop_ctrl && b <= 0x20);
+}
+
+/* Returns the length of the longest prefix of p[0..len) made of bytes
+ * that are ASCII (< 0x80), are neither stop1 nor stop2, and, if
+ * stop_ctrl is set, are not control characters or space (<= 0x20).
+ * Such a prefix is valid UTF-8 with one character per byte, so it can
+ * be copied without decoding.  stop_ctrl is a conservative stand-in
+ * for iswspace(); pass QIO_SCAN_NO_STOP for unused stop bytes.
+ */
+static inline
+size_t qio_scan_plain_ascii(const uint8_t* p, size_t len,
+                            uint8_t stop1, uint8_t stop2, int stop_ctrl)
+{
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  {
+    const __m256i s1 = _mm256_set1_epi8((char) stop1);
+    const __m256i s2 = _mm256_set1_epi8((char) stop2);
+    const __m256i sp = _mm256_set1_epi8(0x20);
+    for( ; i + 32 <= len; i += 32 ) {
+      __m256i v = _mm256_loadu_si256((const __m256i*) (p + i));
+      __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, s1),
+                                    _mm256_cmpeq_epi8(v, s2));
+      uint32_t mask;
+      if( stop_ctrl ) {
+        // v <= 0x20 (unsigned) iff min(v, 0x20) == v
+        hit = _mm256_or_si256(hit,
+                _mm256_cmpeq_epi8(_mm256_min_epu8(v, sp), v));
+      }
+      // movemask picks up the high bit, so non-ASCII bytes stop too
+      mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(hit, v));
+      if( mask ) return i + __builtin_ctz(mask);
+    }
+  }
+#elif defined(__SSE2__)
+  {
+    const __m128i s1 = _mm_set1_epi8((char) stop1);
+    const __m128i s2 = _mm_set1_epi8((char) stop2);
+    const __m128i sp = _mm_set1_epi8(0x20);
+    for( ; i + 16 <= len; i += 16 ) {
+      __m128i v = _mm_loadu_si128((const __m128i*) (p + i));
+      __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, s1),
+                                 _mm_cmpeq_epi8(v, s2));
+      uint32_t mask;
+      if( stop_ctrl ) {
+        // v <= 0x20 (unsigned) iff min(v, 0x20) == v
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(v, sp), v));
+      }
+      // movemask picks up the high bit, so non-ASCII bytes stop too
+      mask = (uint32_t) _mm_movemask_epi8(_mm_or_si128(hit, v));
+      if( mask ) return i + __builtin_ctz(mask);
+    }
+  }
+#endif
+
+  for( ; i < len; i++ ) {
+    if( ! _qio_scan_plain_byte(p[i], stop1, stop2, stop_ctrl) ) break;
+  }
+  return i;
+}
+
+#endif
@@ -41,6 +41,7 @@
 #include "chplcgfns.h"
 #include "chpl-atomics.h"
 #include "chpl-bitops.h"
+#include "chpl-cache-diags.h"
 #include "chpl-comm.h"
 #include "chpl-comm-diags.h"
 #include "chpldirent.h"
@@ -278,6 +278,8 @@ use.
 #include "chpl-atomics.h"
 #include "chpl-thread-local-storage.h" // CHPL_TLS_DECL etc
 #include "chpl-cache.h"
+#include "chpl-cache-diags.h"
+#include "chpl-comm-internal.h" // chpl_comm_bcast_rt_private
 #include "chpl-linefile-support.h"
 #include "sys.h" // sys_page_size()
 #include "chpl-comm-compiler-macros.h"
@@ -341,6 +343,21 @@ typedef int16_t readahead_distance_t;
 #define ENABLE_READAHEAD_TRIGGER_SEQUENTIAL 0
 #define MAX_SEQUENTIAL_READAHEAD_BYTES (MAX_PAGES_PER_PREFETCH*CACHEPAGE_SIZE)
 
+// Should we prefetch for constant-stride GET streams?
+// Each task tracks a few streams of GETs to one node (see
+// chpl_cache_stream_t).  Once STRIDE_PREFETCH_CONFIDENCE GETs in a row
+// have been a fixed stride apart, we prefetch the next few strides
+// ahead.  The prefetch distance starts at STRIDE_PREFETCH_MIN_DISTANCE
+// and doubles, up to STRIDE_PREFETCH_MAX_DISTANCE, whenever a GET has to
+// wait for data that was prefetched for it.  Strides under a cache line
+// are left to sequential readahead, and strides over
+// STRIDE_PREFETCH_MAX_STRIDE are not considered part of the same stream.
+#define ENABLE_STRIDE_PREFETCH 1
+#define STRIDE_PREFETCH_CONFIDENCE 2
+#define STRIDE_PREFETCH_MIN_DISTANCE 2
+#define STRIDE_PREFETCH_MAX_DISTANCE 16
+#define STRIDE_PREFETCH_MAX_STRIDE (64*CACHEPAGE_SIZE)
+
 //#define TIME
 //#define TRACE
 //#define DEBUG
@@ -389,6 +406,45 @@ static long time_duration(const struct timespec* t1, const struct timespec* t2)
 #endif
 
 
+// ----------  DIAGNOSTICS
+//
+// When cache diagnostics are on, cache events are counted both for the
+// task that caused them and in a per-locale aggregate.  The per-task
+// counters live in the cache's task private data, so they need no
+// synchronization; the per-locale ones are atomic.
+//
+typedef struct {
+#define _CACHE_DIAGS_DECL_ATOMIC(cdv) atomic_uint_least64_t cdv;
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_DECL_ATOMIC)
+#undef _CACHE_DIAGS_DECL_ATOMIC
+} cache_atomic_diags_t;
+
+static cache_atomic_diags_t cache_diags_counters;
+
+static chpl_cache_taskPrvData_t* task_private_cache_data(void);
+
+#define cache_diags_add(_ctr, _n)                                       \
+  do {                                                                  \
+    if (chpl_cache_diagnostics) {                                       \
+      uint64_t _diags_n = (_n);                                         \
+      task_private_cache_data()->diags._ctr += _diags_n;                \
+      (void) atomic_fetch_add_uint_least64_t(&cache_diags_counters._ctr, \
+                                             _diags_n);                 \
+    }                                                                   \
+  } while(0)
+
+#define cache_diags_incr(_ctr) cache_diags_add(_ctr, 1)
+
+#define cache_diags_verbose(what, node, size, ln, fn)                   \
+  do {                                                                  \
+    if (chpl_verbose_cache) {                                           \
+      printf("%d: %s:%d: cache %s, node %d, %zu bytes\n",               \
+             (int) chpl_nodeID, chpl_lookupFilename(fn), ln, what,      \
+             (int) (node), (size_t) (size));                            \
+    }                                                                   \
+  } while(0)
+
+
 
 // ----------  SUPPORT FUNCTIONS 
 #include "chpl-cache-support.c"
@@ -1157,6 +1213,8 @@ void ain_evict(struct rdcache_s* cache, struct cache_entry_s* dont_evict_me)
     DOUBLE_PUSH_TAIL(cache, dont_evict_me, ain);
   }
 
+  cache_diags_incr(evictions);
+
 #ifdef DEBUG
   DEBUG_PRINT(("Ain is evicting entry for raddr %p\n", (void*) y->raddr));
   cache_entry_print( y, " ain evict ", 1);
@@ -1201,6 +1259,8 @@ void am_evict(struct rdcache_s *cache, struct cache_entry_s* dont_evict_me) {
     DOUBLE_PUSH_TAIL(cache, dont_evict_me, am_lru);
   }
 
+  cache_diags_incr(evictions);
+
   // If the entry in Am has any pending/dirty requests, we must
   // immediately wait for them to complete, before we modify the contents
   // of Ain in any way (or reuse the associated page).
@@ -1741,6 +1801,7 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
 
           // Save the handle in the list of pending requests.
           entry->max_put_sequence_number = pending_push(cache, handle);
+          cache_diags_incr(write_behind_flushes);
 
           // Move past this region of 1s in dirty bits.
           start = got_skip + got_len;
@@ -2083,13 +2144,18 @@ int is_congested(struct rdcache_s* cache)
   return have > 3 * cache->pending_len / 2;
 }
 
+// cache_get returns a combination of these.
+#define CACHE_GET_MISSED 1     // some of the data had to be fetched
+#define CACHE_GET_PREFETCHED 2 // some of the data had been prefetched
+#define CACHE_GET_WAITED 4     // ... but it had not arrived yet
+
 static
-void cache_get(struct rdcache_s* cache,
-                unsigned char * addr,
-                c_nodeid_t node, raddr_t raddr, size_t size,
-                cache_seqn_t last_acquire,
-                int sequential_readahead_length,
-                int32_t commID, int ln, int32_t fn);
+int cache_get(struct rdcache_s* cache,
+              unsigned char * addr,
+              c_nodeid_t node, raddr_t raddr, size_t size,
+              cache_seqn_t last_acquire,
+              int sequential_readahead_length,
+              int32_t commID, int ln, int32_t fn);
 
 static
 void cache_get_trigger_readahead(struct rdcache_s* cache,
@@ -2178,6 +2244,7 @@ void cache_get_trigger_readahead(struct rdcache_s* cache,
     if( ok && prefetch_start < prefetch_end ) {
       INFO_PRINT(("%i starting readahead from %p to %p\n",
                   (int) chpl_nodeID, (void*) (prefetch_start), (void*) (prefetch_end)));
+      cache_diags_incr(readaheads);
       cache_get(cache, NULL /* prefetch */,
                 node,
                 prefetch_start, prefetch_end - prefetch_start,
@@ -2226,13 +2293,15 @@ int should_readahead_extend(uint64_t* valid,
 
 
 // If addr == NULL, this will prefetch.
+// Returns a combination of the CACHE_GET_ flags describing a non-prefetch
+// GET, or 0 for a prefetch.
 static
-void cache_get(struct rdcache_s* cache,
-                unsigned char * addr,
-                c_nodeid_t node, raddr_t raddr, size_t size,
-                cache_seqn_t last_acquire,
-                int sequential_readahead_length,
-                int32_t commID, int ln, int32_t fn)
+int cache_get(struct rdcache_s* cache,
+              unsigned char * addr,
+              c_nodeid_t node, raddr_t raddr, size_t size,
+              cache_seqn_t last_acquire,
+              int sequential_readahead_length,
+              int32_t commID, int ln, int32_t fn)
 {
   struct cache_entry_s* entry;
   raddr_t ra_first_page;
@@ -2252,6 +2321,13 @@ void cache_get(struct rdcache_s* cache,
   chpl_comm_nb_handle_t handle;
   uintptr_t readahead_len, readahead_skip;
   int ra;
+  // For diagnostics: did any page miss, did any hit use prefetched
+  // data, and how many requested bytes came out of the cache?
+  int any_miss = 0;
+  int any_prefetched = 0;
+  size_t bytes_from_cache = 0;
+  int waited_for_prefetch = 0;
+  int ret = 0;
 #ifdef TIME
   struct timespec start_get1, start_get2, wait1, wait2;
 #endif
@@ -2263,7 +2339,7 @@ void cache_get(struct rdcache_s* cache,
 
   // And don't do anything if it's a zero-length 
   if( size == 0 ) {
-    return;
+    return 0;
   }
 
   // first_page = raddr of start of first needed page
@@ -2394,6 +2470,7 @@ void cache_get(struct rdcache_s* cache,
 #endif
 
             wait_for(cache, entry->max_prefetch_sequence_number);
+            waited_for_prefetch = 1;
 
 #ifdef TIME
             clock_gettime(CLOCK_REALTIME, &wait2);
@@ -2413,6 +2490,10 @@ void cache_get(struct rdcache_s* cache,
           chpl_memcpy(addr+(requested_start-raddr),
                       page+(requested_start-ra_page),
                       requested_size);
+
+          bytes_from_cache += requested_size;
+          if( entry->max_prefetch_sequence_number != NO_SEQUENCE_NUMBER )
+            any_prefetched = 1;
     
           // If we are accessing a page that has a readahead condition,
           // trigger that readahead.
@@ -2456,6 +2537,8 @@ void cache_get(struct rdcache_s* cache,
 
     // Otherwise -- start a get !
 
+    if( ! isprefetch ) any_miss = 1;
+
     if( ! page ) {
       // get a page from the free list.
       page = allocate_page(cache);
@@ -2578,12 +2661,30 @@ void cache_get(struct rdcache_s* cache,
     }
   }
 
+  if( ! isprefetch ) {
+    if( any_miss ) {
+      cache_diags_incr(misses);
+      cache_diags_verbose("get miss", node, size, ln, fn);
+    } else {
+      cache_diags_incr(hits);
+      if( any_prefetched ) cache_diags_incr(prefetch_hits);
+      cache_diags_verbose("get hit", node, size, ln, fn);
+    }
+    cache_diags_add(bytes_saved, bytes_from_cache);
+
+    if( any_miss ) ret |= CACHE_GET_MISSED;
+    if( any_prefetched ) ret |= CACHE_GET_PREFETCHED;
+    if( waited_for_prefetch ) ret |= CACHE_GET_WAITED;
+  }
+
   if( VERIFY ) validate_cache(cache);
 
 #ifdef DUMP
   printf("After cache_get cache is:\n");
   rdcache_print(cache);
 #endif
+
+  return ret;
 }
 
 
@@ -2724,6 +2825,11 @@ void chpl_cache_do_init(void)
 
 void chpl_cache_init(void) {
 
+#define _CACHE_DIAGS_INIT(cdv) \
+        atomic_init_uint_least64_t(&cache_diags_counters.cdv, 0);
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_INIT);
+#undef _CACHE_DIAGS_INIT
+
   if( ! chpl_cache_enabled() ) {
     return;
   }
@@ -2758,6 +2864,10 @@ void chpl_cache_fence(int acquire, int release, int ln, int32_t fn)
     if( acquire ) {
       task_local->last_acquire = cache->next_request_number;
       cache->next_request_number++;
+
+      // Anything prefetched for our streams can no longer be used.
+      for( int i = 0; i < CHPL_CACHE_STREAMS_PER_TASK; i++ )
+        task_local->streams[i].ahead = 0;
     }
 
     if( release ) {
@@ -2780,12 +2890,123 @@ int size_merits_direct_comm(struct rdcache_s* cache, size_t size)
   return size >= CACHEPAGE_SIZE;
 }
 
+// Can we safely prefetch len bytes at raddr on node?  As for readahead,
+// if guard pages are in use or the comm layer can't tell us that the
+// memory is gettable, only allow it within the system page of a GET that
+// the program itself has made.
+static inline
+int stride_prefetch_ok(c_nodeid_t node, raddr_t raddr, size_t len,
+                       raddr_t request_raddr)
+{
+  uintptr_t page_mask = ~((uintptr_t) sys_page_size() - 1);
+
+  if( !chpl_task_guardPagesInUse() &&
+      chpl_comm_addr_gettable(node, (void*) raddr, len) )
+    return 1;
+  return (raddr & page_mask) == (request_raddr & page_mask) &&
+         ((raddr+len-1) & page_mask) == (request_raddr & page_mask);
+}
+
+// Record a GET of size bytes at node:raddr in this task's stream table,
+// and if it continues a constant-stride stream, prefetch ahead of it.
+// got is what cache_get returned for the GET.  Like a hardware stride
+// prefetcher we only learn from GETs that missed or used prefetched
+// data, so that repeated hits on the same few remote locations (for
+// example the fields of a remote array's descriptor) don't push the
+// real streams out of the table.
+static
+void stride_prefetch(struct rdcache_s* cache,
+                     chpl_cache_taskPrvData_t* task_local,
+                     c_nodeid_t node, raddr_t raddr, size_t size,
+                     int got, int ln, int32_t fn)
+{
+  chpl_cache_stream_t* stream = NULL;
+  chpl_cache_stream_t* st;
+  intptr_t delta, best_delta = 0;
+  raddr_t pf_raddr;
+  int i;
+
+  if( ! (got & (CACHE_GET_MISSED|CACHE_GET_PREFETCHED)) )
+    return;
+
+  // Does this GET continue a stream?
+  for( i = 0; i < CHPL_CACHE_STREAMS_PER_TASK; i++ ) {
+    st = &task_local->streams[i];
+    if( ! st->last_raddr || st->node != node )
+      continue;
+    if( st->last_raddr == raddr )
+      return;
+    if( st->stride && st->last_raddr + st->stride == raddr ) {
+      stream = st;
+      break;
+    }
+  }
+
+  if( stream ) {
+    if( stream->confidence < STRIDE_PREFETCH_CONFIDENCE )
+      stream->confidence++;
+    if( stream->ahead > 0 )
+      stream->ahead--;
+    // Our prefetch for this GET arrived late, so look further ahead.
+    if( (got & CACHE_GET_WAITED) &&
+        stream->distance < STRIDE_PREFETCH_MAX_DISTANCE )
+      stream->distance *= 2;
+  } else {
+    // No; start a new stride from the nearest earlier GET to this node,
+    // or failing that, replace one of the streams.
+    for( i = 0; i < CHPL_CACHE_STREAMS_PER_TASK; i++ ) {
+      st = &task_local->streams[i];
+      if( ! st->last_raddr || st->node != node )
+        continue;
+      delta = (intptr_t) (raddr - st->last_raddr);
+      if( delta > STRIDE_PREFETCH_MAX_STRIDE ||
+          delta < -STRIDE_PREFETCH_MAX_STRIDE )
+        continue;
+      if( ! stream || labs(delta) < labs(best_delta) ) {
+        stream = st;
+        best_delta = delta;
+      }
+    }
+    if( ! stream ) {
+      stream = &task_local->streams[task_local->next_stream];
+      task_local->next_stream =
+        (task_local->next_stream + 1) % CHPL_CACHE_STREAMS_PER_TASK;
+    }
+    stream->stride = best_delta;
+    stream->node = node;
+    stream->confidence = 0;
+    stream->distance = STRIDE_PREFETCH_MIN_DISTANCE;
+    stream->ahead = 0;
+  }
+
+  stream->last_raddr = raddr;
+
+  if( stream->confidence < STRIDE_PREFETCH_CONFIDENCE ||
+      (stream->stride < CACHELINE_SIZE && stream->stride > -CACHELINE_SIZE) )
+    return;
+
+  // Prefetch the GETs we expect next, up to distance strides ahead.
+  while( stream->ahead < stream->distance && ! is_congested(cache) ) {
+    pf_raddr = raddr + (stream->ahead + 1) * stream->stride;
+    if( ! stride_prefetch_ok(node, pf_raddr, size, raddr) )
+      break;
+    INFO_PRINT(("%i stride prefetch %i:%p stride %i distance %i\n",
+                (int) chpl_nodeID, (int) node, (void*) pf_raddr,
+                (int) stream->stride, (int) stream->distance));
+    cache_diags_incr(stride_prefetches);
+    cache_get(cache, NULL, node, pf_raddr, size, task_local->last_acquire,
+              0, CHPL_COMM_UNKNOWN_ID, ln, fn);
+    stream->ahead++;
+  }
+}
+
 void chpl_cache_comm_put(void* addr, c_nodeid_t node, void* raddr,
                          size_t size, int32_t commID, int ln, int32_t fn)
 {
   //printf("put len %d node %d raddr %p\n", (int) len * elemSize, node, raddr);
   struct rdcache_s* cache = tls_cache_remote_data();
   if (size_merits_direct_comm(cache, size)) {
+    cache_diags_verbose("put bypass", node, size, ln, fn);
     cache_invalidate(cache, node, (raddr_t)raddr, size);
     chpl_comm_put(addr, node, raddr, size, commID, ln, fn);
     return;
@@ -2814,6 +3035,7 @@ void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
   //printf("get len %d node %d raddr %p\n", (int) len * elemSize, node, raddr);
   struct rdcache_s* cache = tls_cache_remote_data();
   if (size_merits_direct_comm(cache, size)) {
+    cache_diags_verbose("get bypass", node, size, ln, fn);
     cache_invalidate(cache, node, (raddr_t)raddr, size);
     chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
     return;
@@ -2830,8 +3052,12 @@ void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
 #endif
 
   //saturating_increment(&info->get_since_acquire);
-  cache_get(cache, addr, node, (raddr_t)raddr, size, task_local->last_acquire,
-            0, commID, ln, fn);
+  int got = cache_get(cache, addr, node, (raddr_t)raddr, size,
+                      task_local->last_acquire, 0, commID, ln, fn);
+
+  if( ENABLE_STRIDE_PREFETCH )
+    stride_prefetch(cache, task_local, node, (raddr_t)raddr, size, got,
+                    ln, fn);
 
   return;
 }
@@ -2964,3 +3190,95 @@ void chpl_cache_set_enabled(int enabled)
 #endif
 // end ifdef HAS_CHPL_CACHE_FNS
 
+
+//
+// Cache diagnostics.  These are available whether or not this comm
+// layer has a cache, so that programs using them still build and run
+// (reporting no cache activity) when the cache does not exist or has
+// not been enabled with --cache-remote.
+//
+
+int chpl_verbose_cache = 0;
+int chpl_cache_diagnostics = 0;
+
+void chpl_cache_startVerbose(void) {
+  chpl_verbose_cache = 1;
+  chpl_comm_bcast_rt_private(chpl_verbose_cache);
+}
+
+
+void chpl_cache_stopVerbose(void) {
+  chpl_verbose_cache = 0;
+  chpl_comm_bcast_rt_private(chpl_verbose_cache);
+}
+
+
+void chpl_cache_startVerboseHere(void) {
+  chpl_verbose_cache = 1;
+}
+
+
+void chpl_cache_stopVerboseHere(void) {
+  chpl_verbose_cache = 0;
+}
+
+
+void chpl_cache_startDiagnostics(void) {
+  chpl_cache_diagnostics = 1;
+  chpl_comm_bcast_rt_private(chpl_cache_diagnostics);
+}
+
+
+void chpl_cache_stopDiagnostics(void) {
+  chpl_cache_diagnostics = 0;
+  chpl_comm_bcast_rt_private(chpl_cache_diagnostics);
+}
+
+
+void chpl_cache_startDiagnosticsHere(void) {
+  chpl_cache_diagnostics = 1;
+}
+
+
+void chpl_cache_stopDiagnosticsHere(void) {
+  chpl_cache_diagnostics = 0;
+}
+
+
+void chpl_cache_resetDiagnosticsHere(void) {
+#ifdef HAS_CHPL_CACHE_FNS
+#define _CACHE_DIAGS_RESET(cdv) \
+        atomic_store_uint_least64_t(&cache_diags_counters.cdv, 0);
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_RESET);
+#undef _CACHE_DIAGS_RESET
+#endif
+}
+
+
+void chpl_cache_getDiagnosticsHere(chpl_cacheDiagnostics *cd) {
+  memset(cd, 0, sizeof(*cd));
+#ifdef HAS_CHPL_CACHE_FNS
+#define _CACHE_DIAGS_COPY(cdv) \
+        cd->cdv = atomic_load_uint_least64_t(&cache_diags_counters.cdv);
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_COPY);
+#undef _CACHE_DIAGS_COPY
+#endif
+}
+
+
+void chpl_cache_resetTaskDiagnostics(void) {
+#ifdef HAS_CHPL_CACHE_FNS
+  memset(&task_private_cache_data()->diags, 0,
+         sizeof(chpl_cacheDiagnostics));
+#endif
+}
+
+
+void chpl_cache_getTaskDiagnostics(chpl_cacheDiagnostics *cd) {
+#ifdef HAS_CHPL_CACHE_FNS
+  *cd = task_private_cache_data()->diags;
+#else
+  memset(cd, 0, sizeof(*cd));
+#endif
+}
+
@@ -22,6 +22,7 @@
 //  comm/<commlayer>/comm-<commlayer>.c
 //
 #include "chplrt.h"
+#include "chpl-cache-diags.h"
 #include "chpl-comm.h"
 #include "chpl-comm-compiler-macros.h"
 #include "chpl-comm-diags.h"
@@ -118,8 +118,10 @@ void chpl_rt_preUserCodeHook(void) {
 //
 void chpl_rt_postUserCodeHook(void) {
   //
-  // empty
+  // The main task doesn't end the way other tasks do, so give the comm
+  // layer its chance to flush task-private buffers here.
   //
+  chpl_comm_task_end();
 }
 
 
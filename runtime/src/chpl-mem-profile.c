@@ -0,0 +1,431 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ * 
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ * 
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Sampling allocation profiler; see chpl-mem-profile.h.
+//
+#include "chplrt.h"
+
+#include "chpl-mem-profile.h"
+#include "chpl-atomics.h"
+#include "chpl-comm.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem-desc.h"
+#include "chpl-mem-sys.h"
+#include "chpl-thread-local-storage.h"
+#include "chpltypes.h"
+#include "error.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+int chpl_memProfile = 0;
+
+static double sampleRate = 0.0;   /* mean bytes between samples */
+static c_string profileLog = NULL;
+
+
+//
+// Per-site totals.  The byte counts are estimates, scaled up from the
+// samples; the sample counts are exact.
+//
+typedef struct memProfSite_struct {
+  int32_t filename;
+  int32_t lineno;
+  chpl_mem_descInt_t description;
+  uint64_t allocBytes;
+  uint64_t allocSamples;
+  uint64_t liveBytes;
+  uint64_t liveSamples;
+  struct memProfSite_struct* nextInBucket;
+} memProfSite;
+
+//
+// A sampled allocation that has not been freed yet.
+//
+typedef struct memProfSample_struct {
+  void* memAlloc;
+  uint64_t bytes;       /* estimated bytes this sample stands for */
+  memProfSite* site;
+  struct memProfSample_struct* nextInBucket;
+} memProfSample;
+
+#define SITE_HASH_SIZE 1021
+
+static memProfSite** siteTable = NULL;
+static int numSites = 0;
+
+static memProfSample** sampleTable = NULL;
+static size_t sampleHashSize = 0;
+static size_t numSamples = 0;
+
+//
+// Samples are rare, so one lock for both tables is enough.  As for
+// memory tracking, this must be a pthread mutex rather than anything
+// built on the tasking layer, and we never yield while holding it.
+//
+static pthread_mutex_t memProf_lockVar = PTHREAD_MUTEX_INITIALIZER;
+
+//
+// Every free has to find out whether it is releasing a sampled
+// allocation.  To keep that cheap, we keep counts of the live samples
+// whose addresses hash to each slot here, and only take the lock and
+// search the sample table when the count is nonzero.
+//
+#define SAMPLE_FILTER_SIZE 4096
+
+static atomic_uint_least32_t sampleFilter[SAMPLE_FILTER_SIZE];
+
+//
+// Per-thread sampling state.
+//
+typedef struct {
+  int64_t bytesUntilSample;
+  uint64_t randState;
+} memProfThread;
+
+CHPL_TLS_DECL(memProfThread*, memProf_thread);
+
+
+static inline
+uint64_t addrHash(void* memAlloc) {
+  // allocations are aligned, so drop the low bits
+  return ((uint64_t)(uintptr_t)memAlloc >> 4) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+
+static inline
+uint32_t filterIndex(void* memAlloc) {
+  return (uint32_t) (addrHash(memAlloc) >> 52) % SAMPLE_FILTER_SIZE;
+}
+
+
+static uint64_t nextRandom(memProfThread* t) {
+  // xorshift64*
+  t->randState ^= t->randState >> 12;
+  t->randState ^= t->randState << 25;
+  t->randState ^= t->randState >> 27;
+  return t->randState * UINT64_C(2685821657736338717);
+}
+
+
+//
+// Draw the number of bytes until the next sample from an exponential
+// distribution with mean sampleRate.  This makes the sampled bytes a
+// Poisson process, so the chance of sampling an allocation depends
+// only on its size, not on what was allocated before it.
+//
+static int64_t nextSampleInterval(memProfThread* t) {
+  // uniform in (0, 1]
+  double u = ((nextRandom(t) >> 11) + 1) * (1.0 / 9007199254740992.0);
+  double interval = -log(u) * sampleRate;
+  if (interval < 1.0)
+    return 1;
+  if (interval > (double) INT64_MAX / 2)
+    return INT64_MAX / 2;
+  return (int64_t) interval;
+}
+
+
+static memProfThread* getThreadState(void) {
+  memProfThread* t = (memProfThread*) CHPL_TLS_GET(memProf_thread);
+  if (t == NULL) {
+    t = (memProfThread*) sys_malloc(sizeof(*t));
+    if (t == NULL)
+      chpl_internal_error("out of memory for allocation profiling");
+    t->randState = (addrHash(t) ^ (uint64_t) time(NULL)
+                    ^ ((uint64_t) chpl_nodeID << 32)) | 1;
+    t->bytesUntilSample = nextSampleInterval(t);
+    CHPL_TLS_SET(memProf_thread, t);
+  }
+  return t;
+}
+
+
+void chpl_memprofile_init(size_t rate, c_string log) {
+  int i;
+
+  if (rate == 0)
+    return;
+
+  sampleRate = (double) rate;
+  profileLog = (log != NULL && strcmp(log, "")) ? log : "memprofile";
+
+  for (i = 0; i < SAMPLE_FILTER_SIZE; i++)
+    atomic_init_uint_least32_t(&sampleFilter[i], 0);
+
+  siteTable = sys_calloc(SITE_HASH_SIZE, sizeof(memProfSite*));
+  sampleHashSize = 1024;
+  sampleTable = sys_calloc(sampleHashSize, sizeof(memProfSample*));
+  if (siteTable == NULL || sampleTable == NULL)
+    chpl_internal_error("out of memory for allocation profiling");
+
+  CHPL_TLS_INIT(memProf_thread);
+
+  chpl_memProfile = 1;
+}
+
+
+static memProfSite* getSite(chpl_mem_descInt_t description,
+                            int32_t lineno, int32_t filename) {
+  unsigned hashValue = ((unsigned) filename * 31 + (unsigned) lineno) * 31
+                       + (unsigned) description;
+  memProfSite** bucket = &siteTable[hashValue % SITE_HASH_SIZE];
+  memProfSite* site;
+
+  for (site = *bucket; site != NULL; site = site->nextInBucket) {
+    if (site->filename == filename && site->lineno == lineno
+        && site->description == description)
+      return site;
+  }
+
+  site = (memProfSite*) sys_calloc(1, sizeof(memProfSite));
+  if (site == NULL)
+    chpl_internal_error("out of memory for allocation profiling");
+  site->filename = filename;
+  site->lineno = lineno;
+  site->description = description;
+  site->nextInBucket = *bucket;
+  *bucket = site;
+  numSites += 1;
+  return site;
+}
+
+
+static void resizeSampleTable(void) {
+  size_t newHashSize = sampleHashSize * 2;
+  memProfSample** newTable;
+  memProfSample* sample;
+  memProfSample* next;
+  size_t i;
+
+  newTable = sys_calloc(newHashSize, sizeof(memProfSample*));
+  if (newTable == NULL)
+    return; // keep going with longer chains
+
+  for (i = 0; i < sampleHashSize; i++) {
+    for (sample = sampleTable[i]; sample != NULL; sample = next) {
+      size_t h = addrHash(sample->memAlloc) & (newHashSize - 1);
+      next = sample->nextInBucket;
+      sample->nextInBucket = newTable[h];
+      newTable[h] = sample;
+    }
+  }
+
+  sys_free(sampleTable);
+  sampleTable = newTable;
+  sampleHashSize = newHashSize;
+}
+
+
+static void recordSample(void* memAlloc, size_t size,
+                         chpl_mem_descInt_t description,
+                         int32_t lineno, int32_t filename) {
+  //
+  // An allocation of size bytes is sampled with probability
+  // 1 - exp(-size/rate), so weighting it by the inverse of that gives
+  // an unbiased estimate of the bytes allocated at the site.
+  //
+  const double p = 1.0 - exp(-(double) size / sampleRate);
+  const uint64_t bytes = (uint64_t) ((double) size / p + 0.5);
+  memProfSample* sample;
+  memProfSite* site;
+  size_t h;
+
+  sample = (memProfSample*) sys_malloc(sizeof(memProfSample));
+  if (sample == NULL)
+    return; // drop the sample rather than fail the allocation
+
+  (void) pthread_mutex_lock(&memProf_lockVar);
+
+  site = getSite(description, lineno, filename);
+  site->allocBytes += bytes;
+  site->allocSamples += 1;
+  site->liveBytes += bytes;
+  site->liveSamples += 1;
+
+  if (numSamples + 1 > sampleHashSize)
+    resizeSampleTable();
+  h = addrHash(memAlloc) & (sampleHashSize - 1);
+  sample->memAlloc = memAlloc;
+  sample->bytes = bytes;
+  sample->site = site;
+  sample->nextInBucket = sampleTable[h];
+  sampleTable[h] = sample;
+  numSamples += 1;
+
+  (void) atomic_fetch_add_uint_least32_t(&sampleFilter[filterIndex(memAlloc)],
+                                         1);
+
+  (void) pthread_mutex_unlock(&memProf_lockVar);
+}
+
+
+void chpl_memprofile_malloc(void* memAlloc, size_t size,
+                            chpl_mem_descInt_t description,
+                            int32_t lineno, int32_t filename) {
+  memProfThread* t;
+
+  if (memAlloc == NULL || size == 0)
+    return;
+
+  t = getThreadState();
+  t->bytesUntilSample -= (int64_t) size;
+  if (t->bytesUntilSample > 0)
+    return;
+
+  t->bytesUntilSample = nextSampleInterval(t);
+  recordSample(memAlloc, size, description, lineno, filename);
+}
+
+
+void chpl_memprofile_free(void* memAlloc) {
+  memProfSample** prev;
+  memProfSample* sample;
+  uint32_t fi;
+
+  if (memAlloc == NULL)
+    return;
+
+  fi = filterIndex(memAlloc);
+  if (atomic_load_explicit_uint_least32_t(&sampleFilter[fi],
+                                          memory_order_relaxed) == 0)
+    return;
+
+  (void) pthread_mutex_lock(&memProf_lockVar);
+
+  prev = &sampleTable[addrHash(memAlloc) & (sampleHashSize - 1)];
+  for (sample = *prev; sample != NULL; sample = sample->nextInBucket) {
+    if (sample->memAlloc == memAlloc)
+      break;
+    prev = &sample->nextInBucket;
+  }
+
+  if (sample != NULL) {
+    *prev = sample->nextInBucket;
+    sample->site->liveBytes -= sample->bytes;
+    sample->site->liveSamples -= 1;
+    numSamples -= 1;
+    (void) atomic_fetch_sub_uint_least32_t(&sampleFilter[fi], 1);
+  }
+
+  (void) pthread_mutex_unlock(&memProf_lockVar);
+
+  if (sample != NULL)
+    sys_free(sample);
+}
+
+
+static int siteCmp(const void* p1, const void* p2) {
+  memProfSite* s1 = *(memProfSite**)p1;
+  memProfSite* s2 = *(memProfSite**)p2;
+
+  if (s1->allocBytes != s2->allocBytes)
+    return (s1->allocBytes < s2->allocBytes) ? 1 : -1;
+  if (s1->filename != s2->filename)
+    return (s1->filename < s2->filename) ? -1 : 1;
+  if (s1->lineno != s2->lineno)
+    return (s1->lineno < s2->lineno) ? -1 : 1;
+  return (s1->description < s2->description) ? -1
+         : ((s1->description > s2->description) ? 1 : 0);
+}
+
+
+//
+// Write one profile, one line per site, as "<site>;<description> <bytes>".
+//
+static void writeProfile(memProfSite** sites, int n, _Bool live,
+                         const char* suffix) {
+  char* name;
+  FILE* f;
+  int i;
+
+  name = (char*) sys_malloc(strlen(profileLog) + strlen(suffix) + 32);
+  if (name == NULL)
+    return;
+  if (chpl_numNodes == 1)
+    sprintf(name, "%s.%s", profileLog, suffix);
+  else
+    sprintf(name, "%s.%" PRI_c_nodeid_t ".%s", profileLog, chpl_nodeID,
+            suffix);
+
+  f = fopen(name, "w");
+  if (f == NULL) {
+    char message[1024];
+    snprintf(message, sizeof(message),
+             "cannot open allocation profile file \"%s\"", name);
+    chpl_warning(message, 0, 0);
+    sys_free(name);
+    return;
+  }
+
+  for (i = 0; i < n; i++) {
+    const uint64_t bytes = live ? sites[i]->liveBytes : sites[i]->allocBytes;
+    if (bytes == 0)
+      continue;
+    if (sites[i]->filename)
+      fprintf(f, "%s:%" PRId32 ";%s %" PRIu64 "\n",
+              chpl_lookupFilename(sites[i]->filename), sites[i]->lineno,
+              chpl_mem_descString(sites[i]->description), bytes);
+    else
+      fprintf(f, "--;%s %" PRIu64 "\n",
+              chpl_mem_descString(sites[i]->description), bytes);
+  }
+
+  fclose(f);
+  sys_free(name);
+}
+
+
+void chpl_memprofile_report(void) {
+  memProfSite** sites;
+  memProfSite* site;
+  int i, n;
+
+  if (!chpl_memProfile)
+    return;
+
+  (void) pthread_mutex_lock(&memProf_lockVar);
+
+  sites = (memProfSite**) sys_malloc((numSites + 1) * sizeof(memProfSite*));
+  if (sites == NULL) {
+    (void) pthread_mutex_unlock(&memProf_lockVar);
+    chpl_warning("out of memory writing allocation profile", 0, 0);
+    return;
+  }
+
+  n = 0;
+  for (i = 0; i < SITE_HASH_SIZE; i++) {
+    for (site = siteTable[i]; site != NULL; site = site->nextInBucket)
+      sites[n++] = site;
+  }
+  qsort(sites, n, sizeof(memProfSite*), siteCmp);
+
+  writeProfile(sites, n, false /* live */, "alloc");
+  writeProfile(sites, n, true /* live */, "live");
+
+  (void) pthread_mutex_unlock(&memProf_lockVar);
+
+  sys_free(sites);
+}
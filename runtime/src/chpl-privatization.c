@@ -19,74 +19,125 @@
 
 #include "chplrt.h"
 #include "chpl-privatization.h"
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
 #include "chpl-tasks.h"
 
-static int64_t chpl_capPrivateObjects = 0;
+// Protects allocation of new segments and the free pid list; the
+// table itself is read and written without it.
 static chpl_sync_aux_t privatizationSync;
 
-chpl_privateObject_t* chpl_privateObjects = NULL;
+chpl_privateObject_t* chpl_privateObjectSegs[CHPL_PRIVATIZATION_MAX_SEGS];
+
+static atomic_int_least64_t numPrivateObjects;  // live entries here
+static atomic_int_least64_t capPrivateObjects;  // allocated entries here
+
+// Pid management, used on locale 0 only
+static int64_t nextPid = 0;
+static int64_t* freePids = NULL;
+static int64_t numFreePids = 0;
+static int64_t capFreePids = 0;
+static int64_t numPidsReused = 0;
 
 void chpl_privatization_init(void) {
     chpl_sync_initAux(&privatizationSync);
+    atomic_init_int_least64_t(&numPrivateObjects, 0);
+    atomic_init_int_least64_t(&capPrivateObjects, 0);
+}
+
+static inline int segForPid(int64_t pid, int64_t* offset) {
+  const uint64_t j = (uint64_t) pid + CHPL_PRIVATIZATION_SEG0_SIZE;
+  const int msb = 63 - (int) chpl_bitops_clz_64(j);
+  *offset = (int64_t) (j - ((uint64_t) 1 << msb));
+  return msb - CHPL_PRIVATIZATION_SEG0_LOG2;
 }
 
-static inline int64_t max(int64_t a, int64_t b) {
-  return a > b ? a : b;
+static chpl_privateObject_t* getSeg(int seg) {
+  chpl_privateObject_t* segObjs = chpl_privateObjectSegs[seg];
+
+  if (segObjs == NULL) {
+    chpl_sync_lock(&privatizationSync);
+    segObjs = chpl_privateObjectSegs[seg];
+    if (segObjs == NULL) {
+      const int64_t segSize = (int64_t) CHPL_PRIVATIZATION_SEG0_SIZE << seg;
+      segObjs = chpl_mem_allocManyZero(segSize, sizeof(chpl_privateObject_t),
+                                       CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
+      // Make sure the zeroed entries are visible before the segment is.
+      chpl_atomic_thread_fence(memory_order_release);
+      chpl_privateObjectSegs[seg] = segObjs;
+      (void) atomic_fetch_add_int_least64_t(&capPrivateObjects, segSize);
+    }
+    chpl_sync_unlock(&privatizationSync);
+  }
+
+  return segObjs;
 }
 
 // Note that this function can be called in parallel and more notably it can be
 // called with non-monotonic pid's. e.g. this may be called with pid 27, and
-// then pid 2, so it has to ensure that the privatized array has at least pid+1
-// elements. Be __very__ careful if you have to update it.
+// then pid 2.  Segments are allocated on demand and never move, so no
+// entry is ever copied and readers never need the lock.
 void chpl_newPrivatizedClass(void* v, int64_t pid) {
-  chpl_sync_lock(&privatizationSync);
+  int64_t offset;
+  const int seg = segForPid(pid, &offset);
+  chpl_privateObject_t* entry = &getSeg(seg)[offset];
 
-  // initialize array to a default size
-  if (chpl_privateObjects == NULL) {
-    chpl_capPrivateObjects = 2*max(pid, 4);
-    chpl_privateObjects =
-        chpl_mem_allocManyZero(chpl_capPrivateObjects,
-                               sizeof(chpl_privateObject_t),
-                               CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-  } else {
-    // if we're out of space, double (or more) the array size
-    if (pid >= chpl_capPrivateObjects) {
-      chpl_privateObject_t* tmp;
-      int64_t oldCap;
-
-      oldCap = chpl_capPrivateObjects;
-      chpl_capPrivateObjects = 2*max(pid, oldCap);
-
-      tmp = chpl_mem_allocManyZero(chpl_capPrivateObjects,
-                                   sizeof(chpl_privateObject_t),
-                                   CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-      chpl_memcpy((void*)tmp, (void*)chpl_privateObjects,
-                  (oldCap)*sizeof(chpl_privateObject_t));
-      chpl_privateObjects = tmp;
-      // purposely leak old copies of chpl_privateObject to avoid the need to
-      // lock chpl_getPrivatizedClass; TODO: fix with lock free data structure
-    }
+  if (entry->obj == NULL && v != NULL)
+    (void) atomic_fetch_add_int_least64_t(&numPrivateObjects, 1);
+  entry->obj = v;
+}
+
+void chpl_clearPrivatizedClass(int64_t i) {
+  int64_t offset;
+  const int seg = segForPid(i, &offset);
+
+  if (chpl_privateObjectSegs[seg] != NULL
+      && chpl_privateObjectSegs[seg][offset].obj != NULL) {
+    chpl_privateObjectSegs[seg][offset].obj = NULL;
+    (void) atomic_fetch_sub_int_least64_t(&numPrivateObjects, 1);
   }
-  chpl_privateObjects[pid].obj = v;
+}
 
+int64_t chpl_privatization_newPid(void) {
+  int64_t pid;
+
+  chpl_sync_lock(&privatizationSync);
+  if (numFreePids > 0) {
+    pid = freePids[--numFreePids];
+    numPidsReused++;
+  } else {
+    pid = nextPid++;
+  }
   chpl_sync_unlock(&privatizationSync);
+
+  return pid;
 }
 
-void chpl_clearPrivatizedClass(int64_t i) {
+void chpl_privatization_freePid(int64_t pid) {
   chpl_sync_lock(&privatizationSync);
-  chpl_privateObjects[i].obj = NULL;
+  if (numFreePids == capFreePids) {
+    capFreePids = (capFreePids == 0) ? CHPL_PRIVATIZATION_SEG0_SIZE
+                                     : 2 * capFreePids;
+    freePids = chpl_mem_realloc(freePids, capFreePids * sizeof(int64_t),
+                                CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
+  }
+  freePids[numFreePids++] = pid;
   chpl_sync_unlock(&privatizationSync);
 }
 
 // Used to check for leaks of privatized classes
 int64_t chpl_numPrivatizedClasses(void) {
-  int64_t ret = 0;
+  return atomic_load_int_least64_t(&numPrivateObjects);
+}
+
+int64_t chpl_privatizedClassesCapacity(void) {
+  return atomic_load_int_least64_t(&capPrivateObjects);
+}
+
+int64_t chpl_numPrivatizedPidsReused(void) {
+  int64_t ret;
   chpl_sync_lock(&privatizationSync);
-  for (int64_t i = 0; i < chpl_capPrivateObjects; i++) {
-    if (chpl_privateObjects[i].obj)
-      ret++;
-  }
+  ret = numPidsReused;
   chpl_sync_unlock(&privatizationSync);
   return ret;
 }
@@ -20,8 +20,10 @@
 #include "chplrt.h"
 
 #include "chplmemtrack.h"
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
 #include "chpl-mem-desc.h"
+#include "chpl-mem-profile.h"
 #include "chpl-mem-sys.h"  // mem layer not initialized yet, need system alloc
 #include "chpl-tasks.h"
 #include "chpltypes.h"
@@ -62,7 +64,9 @@ extern void chpl_memTracking_returnConfigVals(chpl_bool* memTrack,
                                               size_t* memMax,
                                               size_t* memThreshold,
                                               c_string* memLog,
-                                              c_string* memLeaksLog);
+                                              c_string* memLeaksLog,
+                                              size_t* memProfileRate,
+                                              c_string* memProfileLog);
 
 typedef struct memTableEntry_struct { /* table entry */
   size_t number;
@@ -74,16 +78,48 @@ typedef struct memTableEntry_struct { /* table entry */
   struct memTableEntry_struct* nextInBucket;
 } memTableEntry;
 
-#define NUM_HASH_SIZE_INDICES 20
+#define NUM_HASH_SIZE_INDICES 24
 
-static int hashSizes[NUM_HASH_SIZE_INDICES] = { 1543, 3079, 6151, 12289, 24593, 49157, 98317,
+static int hashSizes[NUM_HASH_SIZE_INDICES] = { 97, 193, 389, 769,
+                                                1543, 3079, 6151, 12289, 24593, 49157, 98317,
                                                 196613, 393241, 786433, 1572869, 3145739,
                                                 6291469, 12582917, 25165843, 50331653,
                                                 100663319, 201326611, 402653189, 805306457 };
-static int hashSizeIndex = 0;
-static int hashSize = 0;
 
-static memTableEntry** memTable = NULL;
+//
+// The table of live allocations is split into shards, each covering
+// the addresses that hash to it and each with its own lock, buckets,
+// and byte counts.  Tasks allocating and freeing different memory
+// thus rarely contend with one another.  The per-shard counts are
+// only summed when a report is printed.  The current and high water
+// totals are needed on every allocation for --memMax and the high
+// water mark, so those are kept in global atomics instead.
+//
+#define MEMTRACK_SHARD_BITS 6
+#define NUM_MEMTRACK_SHARDS (1 << MEMTRACK_SHARD_BITS)
+
+typedef struct memTableShard_struct {
+  // We can't use a sync var for concurrency control here.  The
+  // Qthreads internal memory allocator shim references this memory
+  // tracking code via the Chapel runtime public memory layer interface.
+  // Referring to a sync var here when exiting (to report memTrack
+  // results, say), after the tasking layer is shut down, ends up trying
+  // to create a qthread in the terminated Qthreads library.  Chaos
+  // results.  So, we use a pthread mutex.  Note that this is only safe
+  // if we cannot switch tasks on a pthread while holding the mutex and
+  // then try to lock it recursively.  Currently that is the case, since
+  // we do not yield while holding the mutex.
+  pthread_mutex_t lock;
+  memTableEntry** table;
+  int hashSizeIndex;
+  int hashSize;
+  size_t entries;   /* number of entries in this shard */
+  size_t allocated; /* memory allocated, for addresses in this shard */
+  size_t freed;     /* memory freed, for addresses in this shard */
+  char pad[64];     /* keep neighboring shards off each other's lines */
+} memTableShard;
+
+static memTableShard memShards[NUM_MEMTRACK_SHARDS];
 
 static _Bool memStats = false;
 static _Bool memLeaksByType = false;
@@ -95,41 +131,51 @@ static c_string memLog = NULL;
 static FILE* memLogFile = NULL;
 static c_string memLeaksLog = NULL;
 
-static size_t totalMem = 0;       /* total memory currently allocated */
-static size_t maxMem = 0;         /* maximum total memory during run  */
-static size_t totalAllocated = 0; /* total memory allocated */
-static size_t totalFreed = 0;     /* total memory freed */
-static size_t totalEntries = 0;     /* number of entries in hash table */
-
-
-// We can't use a sync var for concurrency control here.  The Qthreads
-// internal memory allocator shim references this memory tracking code
-// via the Chapel runtime public memory layer interface.  Referring to a
-// sync var here when exiting (to report memTrack results, say), after
-// the tasking layer is shut down, ends up trying to create a qthread in
-// the terminated Qthreads library.  Chaos results.  We also cannot use
-// an atomic var, because with CHPL_ATOMICS=locks those are implemented
-// by means of sync vars.  So, we use a pthread mutex.  Note that this
-// is only safe if we cannot switch tasks on a pthread while holding the
-// mutex and then try to lock it recursively.  Currently that is the
-// case, since we do not yield while holding the mutex.
-// 
-static pthread_mutex_t memTrack_lockVar = PTHREAD_MUTEX_INITIALIZER;
+//
+// Runtime atomics are safe here even with CHPL_ATOMICS=locks, because
+// those are implemented using pthread mutexes rather than sync vars.
+//
+static atomic_uint_least64_t totalMem; /* total memory currently allocated */
+static atomic_uint_least64_t maxMem;   /* maximum total memory during run  */
+
 
 static inline
-void memTrack_lock(void) {
-  (void) pthread_mutex_lock(&memTrack_lockVar);
+memTableShard* memTrack_shard(void* memAlloc) {
+  // Fibonacci hashing; allocations are aligned, so drop the low bits
+  uint64_t h = ((uint64_t)(uintptr_t)memAlloc >> 4) * UINT64_C(0x9E3779B97F4A7C15);
+  return &memShards[h >> (64 - MEMTRACK_SHARD_BITS)];
 }
 
 static inline
-void memTrack_unlock(void) {
-  (void) pthread_mutex_unlock(&memTrack_lockVar);
+void memTrack_lock(memTableShard* shard) {
+  (void) pthread_mutex_lock(&shard->lock);
+}
+
+static inline
+void memTrack_unlock(memTableShard* shard) {
+  (void) pthread_mutex_unlock(&shard->lock);
+}
+
+// Reports that need a consistent view of all shards take every lock,
+// always in the same order.
+static void lockAllShards(void) {
+  int i;
+  for (i = 0; i < NUM_MEMTRACK_SHARDS; i++)
+    memTrack_lock(&memShards[i]);
+}
+
+static void unlockAllShards(void) {
+  int i;
+  for (i = NUM_MEMTRACK_SHARDS - 1; i >= 0; i--)
+    memTrack_unlock(&memShards[i]);
 }
 
 
 
 void chpl_setMemFlags(void) {
   chpl_bool local_memTrack = false;
+  size_t memProfileRate = 0;
+  c_string memProfileLog = NULL;
 
   //
   // Get the values of the memTracking config consts from the module.
@@ -154,7 +200,9 @@ void chpl_setMemFlags(void) {
                                     &memMax,
                                     &memThreshold,
                                     &memLog,
-                                    &memLeaksLog);
+                                    &memLeaksLog,
+                                    &memProfileRate,
+                                    &memProfileLog);
 
   chpl_memTrack = (local_memTrack
                    || memStats
@@ -179,10 +227,19 @@ void chpl_setMemFlags(void) {
   }
 
   if (chpl_memTrack) {
-    hashSizeIndex = 0;
-    hashSize = hashSizes[hashSizeIndex];
-    memTable = sys_calloc(hashSize, sizeof(memTableEntry*));
+    int i;
+    atomic_init_uint_least64_t(&totalMem, 0);
+    atomic_init_uint_least64_t(&maxMem, 0);
+    for (i = 0; i < NUM_MEMTRACK_SHARDS; i++) {
+      memTableShard* shard = &memShards[i];
+      (void) pthread_mutex_init(&shard->lock, NULL);
+      shard->hashSizeIndex = 0;
+      shard->hashSize = hashSizes[shard->hashSizeIndex];
+      shard->table = sys_calloc(shard->hashSize, sizeof(memTableEntry*));
+    }
   }
+
+  chpl_memprofile_init(memProfileRate, memProfileLog);
 }
 
 
@@ -198,37 +255,47 @@ static unsigned hash(void* memAlloc, int hashSize) {
 }
 
 
-static void increaseMemStat(size_t chunk, int32_t lineno, int32_t filename) {
-  totalMem += chunk;
-  totalAllocated += chunk;
-  if (memMax && (totalMem > memMax)) {
+static void increaseMemStat(memTableShard* shard, size_t chunk,
+                            int32_t lineno, int32_t filename) {
+  uint_least64_t newTotal;
+  uint_least64_t oldMax;
+
+  shard->allocated += chunk;
+  newTotal = atomic_fetch_add_uint_least64_t(&totalMem, chunk) + chunk;
+  if (memMax && (newTotal > memMax)) {
     chpl_error("Exceeded memory limit", lineno, filename);
   }
-  if (totalMem > maxMem)
-    maxMem = totalMem;
+  oldMax = atomic_load_explicit_uint_least64_t(&maxMem, memory_order_relaxed);
+  while (newTotal > oldMax) {
+    if (atomic_compare_exchange_strong_uint_least64_t(&maxMem, oldMax,
+                                                       newTotal))
+      break;
+    oldMax = atomic_load_explicit_uint_least64_t(&maxMem,
+                                                 memory_order_relaxed);
+  }
 }
 
 
-static void decreaseMemStat(size_t chunk) {
-  totalMem -= chunk; // > totalMem ? 0 : totalMem - chunk;
-  totalFreed += chunk;
+static void decreaseMemStat(memTableShard* shard, size_t chunk) {
+  shard->freed += chunk;
+  (void) atomic_fetch_sub_uint_least64_t(&totalMem, chunk);
 }
 
 
 static void
-resizeTable(int direction) {
+resizeTable(memTableShard* shard, int direction) {
   memTableEntry** newMemTable = NULL;
   int newHashSizeIndex, newHashSize, newHashValue;
   int i;
   memTableEntry* me;
   memTableEntry* next;
 
-  newHashSizeIndex = hashSizeIndex + direction;
+  newHashSizeIndex = shard->hashSizeIndex + direction;
   newHashSize = hashSizes[newHashSizeIndex];
   newMemTable = sys_calloc(newHashSize, sizeof(memTableEntry*));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = next) {
+  for (i = 0; i < shard->hashSize; i++) {
+    for (me = shard->table[i]; me != NULL; me = next) {
       next = me->nextInBucket;
       newHashValue = hash(me->memAlloc, newHashSize);
       me->nextInBucket = newMemTable[newHashValue];
@@ -236,20 +303,22 @@ resizeTable(int direction) {
     }
   }
 
-  sys_free(memTable);
-  memTable = newMemTable;
-  hashSize = newHashSize;
-  hashSizeIndex = newHashSizeIndex;
+  sys_free(shard->table);
+  shard->table = newMemTable;
+  shard->hashSize = newHashSize;
+  shard->hashSizeIndex = newHashSizeIndex;
 }
 
-static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
+static void addMemTableEntry(memTableShard* shard,
+                             void *memAlloc, size_t number, size_t size,
                              chpl_mem_descInt_t description, int32_t lineno,
                              int32_t filename) {
   unsigned hashValue;
   memTableEntry* memEntry;
 
-  if ((totalEntries+1)*2 > hashSize && hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
-    resizeTable(1);
+  if ((shard->entries+1)*2 > shard->hashSize
+      && shard->hashSizeIndex < NUM_HASH_SIZE_INDICES-1)
+    resizeTable(shard, 1);
 
   memEntry = (memTableEntry*) sys_calloc(1, sizeof(memTableEntry));
   if (!memEntry) {
@@ -257,33 +326,34 @@ static void addMemTableEntry(void *memAlloc, size_t number, size_t size,
                lineno, filename);
   }
 
-  hashValue = hash(memAlloc, hashSize);
-  memEntry->nextInBucket = memTable[hashValue];
-  memTable[hashValue] = memEntry;
+  hashValue = hash(memAlloc, shard->hashSize);
+  memEntry->nextInBucket = shard->table[hashValue];
+  shard->table[hashValue] = memEntry;
   memEntry->description = description;
   memEntry->memAlloc = memAlloc;
   memEntry->lineno = lineno;
   memEntry->filename = filename;
   memEntry->number = number;
   memEntry->size = size;
-  increaseMemStat(number*size, lineno, filename);
-  totalEntries += 1;
+  increaseMemStat(shard, number*size, lineno, filename);
+  shard->entries += 1;
 }
 
 
-static memTableEntry* removeMemTableEntry(void* address) {
-  unsigned hashValue = hash(address, hashSize);
-  memTableEntry* thisBucketEntry = memTable[hashValue];
+static memTableEntry* removeMemTableEntry(memTableShard* shard,
+                                          void* address) {
+  unsigned hashValue = hash(address, shard->hashSize);
+  memTableEntry* thisBucketEntry = shard->table[hashValue];
   memTableEntry* deletedBucket = NULL;
 
   if (!thisBucketEntry)
     return NULL;
 
   if (thisBucketEntry->memAlloc == address) {
-    memTable[hashValue] = thisBucketEntry->nextInBucket;
+    shard->table[hashValue] = thisBucketEntry->nextInBucket;
     deletedBucket = thisBucketEntry;
   } else {
-    for (thisBucketEntry = memTable[hashValue];
+    for (thisBucketEntry = shard->table[hashValue];
          thisBucketEntry != NULL;
          thisBucketEntry = thisBucketEntry->nextInBucket) {
 
@@ -296,10 +366,10 @@ static memTableEntry* removeMemTableEntry(void* address) {
     }
   }
   if (deletedBucket) {
-    decreaseMemStat(deletedBucket->number * deletedBucket->size);
-    totalEntries -= 1;
-    if (totalEntries*8 < hashSize && hashSizeIndex > 0)
-      resizeTable(-1);
+    decreaseMemStat(shard, deletedBucket->number * deletedBucket->size);
+    shard->entries -= 1;
+    if (shard->entries*8 < shard->hashSize && shard->hashSizeIndex > 0)
+      resizeTable(shard, -1);
   }
   return deletedBucket;
 }
@@ -312,7 +382,7 @@ uint64_t chpl_memoryUsed(int32_t lineno, int32_t filename) {
     return 0;
   }
 
-  return (uint64_t)totalMem;
+  return (uint64_t)atomic_load_uint_least64_t(&totalMem);
 }
 
 
@@ -343,18 +413,35 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
              nodeWidth, chpl_nodeID);
   }
 
+  //
+  // Merge the counts from the shards.  Holding every shard lock at once
+  // keeps the totals consistent with each other.
+  //
+  size_t totalAllocated = 0;
+  size_t totalFreed = 0;
+  size_t nowMem, highMem;
+
+  lockAllShards();
+  for (int i = 0; i < NUM_MEMTRACK_SHARDS; i++) {
+    totalAllocated += memShards[i].allocated;
+    totalFreed += memShards[i].freed;
+  }
+  nowMem = (size_t) atomic_load_uint_least64_t(&totalMem);
+  highMem = (size_t) atomic_load_uint_least64_t(&maxMem);
+  unlockAllShards();
+
   //
   // Take a pre-run through the descriptions and values to figure
   // out how long each line will need to be.
   //
-  static const struct {
+  const struct {
     const char* desc;
-    size_t* val;
+    size_t val;
   } descsVals[] = {
-    { "Allocated Now:", &totalMem },
-    { "Allocation High Water Mark:", &maxMem },
-    { "Sum of Allocations:", &totalAllocated },
-    { "Sum of Frees:", &totalFreed },
+    { "Allocated Now:", nowMem },
+    { "Allocation High Water Mark:", highMem },
+    { "Sum of Allocations:", totalAllocated },
+    { "Sum of Frees:", totalFreed },
   };
   const int nDescsVals = sizeof(descsVals) / sizeof(descsVals[0]);
 
@@ -366,9 +453,9 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
     if (thisDescWidth > descWidth)
       descWidth = thisDescWidth;
     const int thisMemWidth =
-                (*descsVals[i].val == 0)
+                (descsVals[i].val == 0)
                 ? 1
-                : (int) lrint(ceil(log10((double) *descsVals[i].val)));
+                : (int) lrint(ceil(log10((double) descsVals[i].val)));
     if (thisMemWidth > memWidth)
       memWidth = thisMemWidth;
   }
@@ -380,19 +467,15 @@ void chpl_printMemAllocStats(int32_t lineno, int32_t filename) {
   char buf[4 * (strlen(prefixBuf) + 1 + descWidth + 1 + memWidth + 1) + 1];
   size_t len;
 
-  memTrack_lock();
-
   len = 0;
   for (int i = 0; i < nDescsVals; i++) {
     len += snprintf(buf + len, sizeof(buf) - len,
                     "%s %-*s %*zd\n",
                     prefixBuf,
                     descWidth, descsVals[i].desc,
-                    memWidth, *descsVals[i].val);
+                    memWidth, descsVals[i].val);
   }
 
-  memTrack_unlock();
-
   fputs(buf, memLogFile);
 }
 
@@ -407,7 +490,7 @@ static void printMemAllocsByType(_Bool forLeaks,
                                  int32_t lineno, int32_t filename) {
   size_t* table;
   memTableEntry* me;
-  int i;
+  int s, i;
   const int numberWidth   = 9;
   const int numEntries = CHPL_RT_MD_NUM+chpl_mem_numDescs;
 
@@ -420,12 +503,17 @@ static void printMemAllocsByType(_Bool forLeaks,
 
   table = (size_t*)sys_calloc(numEntries, 3*sizeof(size_t));
 
-  for (i = 0; i < hashSize; i++) {
-    for (me = memTable[i]; me != NULL; me = me->nextInBucket) {
-      table[3*me->description] += me->number*me->size;
-      table[3*me->description+1] += 1;
-      table[3*me->description+2] = me->description;
+  for (s = 0; s < NUM_MEMTRACK_SHARDS; s++) {
+    memTableShard* shard = &memShards[s];
+    memTrack_lock(shard);
+    for (i = 0; i < shard->hashSize; i++) {
+      for (me = shard->table[i]; me != NULL; me = me->nextInBucket) {
+        table[3*me->description] += me->number*me->size;
+        table[3*me->description+1] += 1;
+        table[3*me->description+2] = me->description;
+      }
     }
+    memTrack_unlock(shard);
   }
 
   qsort(table, numEntries, 3*sizeof(size_t), memTableEntryCmp);
@@ -526,7 +614,7 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
 
   memTableEntry* memEntry;
   c_string memEntryFilename;
-  int n, i;
+  int n, s, i;
   char* loc;
   memTableEntry** table;
 
@@ -536,21 +624,28 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     return;
   }
 
+  // Keep the entries from changing or being freed while we report them.
+  lockAllShards();
+
   n = 0;
   filenameWidth = strlen("Allocated Memory (Bytes)");
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      n += 1;
-      if (memEntry->filename) {
-        memEntryFilename = chpl_lookupFilename(memEntry->filename);
-        filenameLength = strlen(memEntryFilename);
-        if (filenameLength > filenameWidth)
-          filenameWidth = filenameLength;
+  for (s = 0; s < NUM_MEMTRACK_SHARDS; s++) {
+    for (i = 0; i < memShards[s].hashSize; i++) {
+      for (memEntry = memShards[s].table[i];
+           memEntry != NULL;
+           memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        n += 1;
+        if (memEntry->filename) {
+          memEntryFilename = chpl_lookupFilename(memEntry->filename);
+          filenameLength = strlen(memEntryFilename);
+          if (filenameLength > filenameWidth)
+            filenameWidth = filenameLength;
+        }
       }
     }
   }
@@ -575,14 +670,18 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
     chpl_error("out of memory printing memory table", lineno, filename);
 
   n = 0;
-  for (i = 0; i < hashSize; i++) {
-    for (memEntry = memTable[i]; memEntry != NULL; memEntry = memEntry->nextInBucket) {
-      size_t chunk = memEntry->number * memEntry->size;
-      if (chunk < threshold)
-        continue;
-      if (description != -1 && memEntry->description != description)
-        continue;
-      table[n++] = memEntry;
+  for (s = 0; s < NUM_MEMTRACK_SHARDS; s++) {
+    for (i = 0; i < memShards[s].hashSize; i++) {
+      for (memEntry = memShards[s].table[i];
+           memEntry != NULL;
+           memEntry = memEntry->nextInBucket) {
+        size_t chunk = memEntry->number * memEntry->size;
+        if (chunk < threshold)
+          continue;
+        if (description != -1 && memEntry->description != description)
+          continue;
+        table[n++] = memEntry;
+      }
     }
   }
   qsort(table, n, sizeof(memTableEntry*), descCmp);
@@ -610,12 +709,15 @@ printMemAllocs(chpl_mem_descInt_t description, int64_t threshold,
   fprintf(memLogFile, "\n");
   putchar('\n');
 
+  unlockAllShards();
+
   sys_free(table);
   sys_free(loc);
 }
 
 
 void chpl_reportMemInfo() {
+  chpl_memprofile_report();
   if (memStats) {
     fprintf(memLogFile, "\n");
     chpl_printMemAllocStats(0, 0);
@@ -651,9 +753,11 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
                        int32_t lineno, int32_t filename) {
   if (number * size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(memAlloc, number, size, description, lineno, filename);
-      memTrack_unlock();
+      memTableShard* shard = memTrack_shard(memAlloc);
+      memTrack_lock(shard);
+      addMemTableEntry(shard, memAlloc, number, size, description,
+                       lineno, filename);
+      memTrack_unlock(shard);
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -669,8 +773,9 @@ void chpl_track_malloc(void* memAlloc, size_t number, size_t size,
 void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
   if (chpl_memTrack) {
-    memTrack_lock();
-    memEntry = removeMemTableEntry(memAlloc);
+    memTableShard* shard = memTrack_shard(memAlloc);
+    memTrack_lock(shard);
+    memEntry = removeMemTableEntry(shard, memAlloc);
     if (memEntry) {
       if (chpl_verbose_mem) {
         fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
@@ -681,7 +786,7 @@ void chpl_track_free(void* memAlloc, int32_t lineno, int32_t filename) {
       }
       sys_free(memEntry);
     }
-    memTrack_unlock();
+    memTrack_unlock(shard);
   } else if (chpl_verbose_mem && !memEntry) {
     fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32 ": free at %p\n",
             chpl_nodeID, (filename ? chpl_lookupFilename(filename) : "--"),
@@ -695,14 +800,13 @@ void chpl_track_realloc_pre(void* memAlloc, size_t size,
                          int32_t lineno, int32_t filename) {
   memTableEntry* memEntry = NULL;
 
-  if (chpl_memTrack && size > memThreshold) {
-    memTrack_lock();
-    if (memAlloc) {
-      memEntry = removeMemTableEntry(memAlloc);
-      if (memEntry)
-        sys_free(memEntry);
-    }
-    memTrack_unlock();
+  if (chpl_memTrack && size > memThreshold && memAlloc) {
+    memTableShard* shard = memTrack_shard(memAlloc);
+    memTrack_lock(shard);
+    memEntry = removeMemTableEntry(shard, memAlloc);
+    memTrack_unlock(shard);
+    if (memEntry)
+      sys_free(memEntry);
   }
 }
 
@@ -713,9 +817,11 @@ void chpl_track_realloc_post(void* moreMemAlloc,
                          int32_t lineno, int32_t filename) {
   if (size > memThreshold) {
     if (chpl_memTrack && chpl_mem_descTrack(description)) {
-      memTrack_lock();
-      addMemTableEntry(moreMemAlloc, 1, size, description, lineno, filename);
-      memTrack_unlock();
+      memTableShard* shard = memTrack_shard(moreMemAlloc);
+      memTrack_lock(shard);
+      addMemTableEntry(shard, moreMemAlloc, 1, size, description,
+                       lineno, filename);
+      memTrack_unlock(shard);
     }
     if (chpl_verbose_mem) {
       fprintf(memLogFile, "%" PRI_c_nodeid_t ": %s:%" PRId32
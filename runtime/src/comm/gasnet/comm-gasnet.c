@@ -44,6 +44,7 @@
 // Don't get warning macros for chpl_comm_get etc
 #include "chpl-comm-no-warning-macros.h"
 
+#include <pthread.h>
 #include <signal.h>
 #include <sched.h>
 #include <stdint.h>
@@ -241,6 +242,7 @@ typedef enum {
   FORK_NB_LARGE,        // non-blocking fork with a huge argument
   FORK_FAST,            // run the function in the handler (use with care)
   FORK_FAST_SMALL,      // run the function in the handler (use with care)
+  FORK_NB_BATCH,        // a batch of non-blocking small forks
 
   SIGNAL,               // ack to a done_t via gasnet_AMReplyShortM()
   SIGNAL_LONG,          // ack to a done_t via gasnet_AMReplyLongM()
@@ -436,6 +438,32 @@ static void AM_fork_nb_small(gasnet_token_t  token,
 }
 
 
+//
+// A batch of non-blocking small forks is a sequence of entries, each
+// holding a small fork message, padded so the next entry is aligned.
+//
+typedef struct {
+  uint32_t nbytes;      // size of the small fork message that follows
+  uint32_t pad;
+} fork_batch_entry_t;
+
+#define FORK_BATCH_ENTRY_SIZE(nbytes)                                   \
+  ((sizeof(fork_batch_entry_t) + (nbytes) + 7) & ~(size_t) 7)
+
+static void AM_fork_nb_batch(gasnet_token_t  token,
+                             void           *buf,
+                             size_t          nbytes) {
+  char* p = buf;
+  char* end = p + nbytes;
+
+  while (p < end) {
+    fork_batch_entry_t* e = (fork_batch_entry_t*) p;
+    AM_fork_nb_small(token, e + 1, e->nbytes);
+    p += FORK_BATCH_ENTRY_SIZE(e->nbytes);
+  }
+}
+
+
 static void fork_nb_large_wrapper(large_fork_task_t* f) {
   large_fork_t *lg = &f->large;
   chpl_comm_on_bundle_t* arg;
@@ -579,6 +607,7 @@ static gasnet_handlerentry_t ftable[] = {
   {FORK_NB_LARGE, AM_fork_nb_large},
   {FORK_FAST,     AM_fork_fast},
   {FORK_FAST_SMALL, AM_fork_fast_small},
+  {FORK_NB_BATCH, AM_fork_nb_batch},
   {SIGNAL,        AM_signal},
   {SIGNAL_LONG,   AM_signal_long},
   {PRIV_BCAST,    AM_priv_bcast},
@@ -721,11 +750,14 @@ static volatile int pollingRunning;
 static volatile int pollingQuit;
 static chpl_bool pollingRequired;
 
+static void fork_batch_flush_expired(void);
+
 static void polling(void* x) {
   pollingRunning = 1;
 
   while (!pollingQuit) {
     (void) gasnet_AMPoll();
+    fork_batch_flush_expired();
     chpl_task_yield();
   }
 
@@ -895,7 +927,10 @@ int chpl_comm_run_in_gdb(int argc, char* argv[], int gdbArgnum, int* status) {
   return 0;
 }
 
+static void init_fork_batches(void);
+
 void chpl_comm_post_task_init(void) {
+  init_fork_batches();
   start_polling();
 }
 
@@ -1020,7 +1055,11 @@ void chpl_comm_barrier(const char *msg) {
   GASNET_Safe_Retval(gasnet_barrier_try(id, 0), retval);
 }
 
+static void fork_batch_flush_all(void);
+
 void chpl_comm_pre_task_exit(int all) {
+  fork_batch_flush_all();
+
   if (all) {
 
     if (chpl_nodeID == 0) {
@@ -1335,7 +1374,69 @@ void  chpl_comm_put_strd(void* dstaddr, size_t* dststrides, c_nodeid_t dstnode_i
   gasnet_puts_bulk(dstnode, dstaddr, dststr, srcaddr, srcstr, cnt, strlvls); 
 }
 
+//
+// Unordered GETs and PUTs
+//
+// These are started as non-blocking GASNet operations and their handles
+// are kept in a per-task buffer.  The buffer is synced when it fills
+// up, at the task fence, and when the task ends.  A non-bulk PUT lets
+// the caller reuse the source as soon as it has been started, so only
+// the handles need to be buffered.  Transfers that cannot be done as
+// RDMA, because the remote address is outside the segment, fall back to
+// the blocking routines, which are ordered anyway.
+//
 #define MAX_UNORDERED_TRANS_SZ 1024
+#define MAX_UNORDERED_HANDLES 64
+
+typedef struct {
+  int vi;
+  gasnet_handle_t handle_v[MAX_UNORDERED_HANDLES];
+} unordered_buff_task_info_t;
+
+static inline
+chpl_comm_taskPrvData_t* get_comm_taskPrvdata(void) {
+  chpl_task_prvData_t* task_prvData = chpl_task_getPrvData();
+  if (task_prvData != NULL) return &task_prvData->comm_data;
+  return NULL;
+}
+
+// Acquire the task local buffer, initializing it if needed
+static inline
+unordered_buff_task_info_t* unordered_buff_acquire(void) {
+  chpl_comm_taskPrvData_t* prvData = get_comm_taskPrvdata();
+  unordered_buff_task_info_t* info;
+
+  if (prvData == NULL) return NULL;
+
+  info = prvData->unordered_buff;
+  if (info == NULL) {
+    info = chpl_mem_alloc(sizeof(unordered_buff_task_info_t),
+                          CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+    info->vi = 0;
+    prvData->unordered_buff = info;
+  }
+  return info;
+}
+
+// Wait for all of the buffered operations and reset the buffer
+static inline
+void unordered_buff_flush(unordered_buff_task_info_t* info) {
+  if (info->vi > 0) {
+    gasnet_wait_syncnb_all(info->handle_v, info->vi);
+    info->vi = 0;
+  }
+}
+
+static inline
+void unordered_buff_add(unordered_buff_task_info_t* info,
+                        gasnet_handle_t handle) {
+  if (handle == GASNET_INVALID_HANDLE)
+    return; // already complete
+  if (info->vi == MAX_UNORDERED_HANDLES)
+    unordered_buff_flush(info);
+  info->handle_v[info->vi++] = handle;
+}
+
 void chpl_comm_getput_unordered(c_nodeid_t dstnode, void* dstaddr,
                                 c_nodeid_t srcnode, void* srcaddr,
                                 size_t size, int32_t commID,
@@ -1352,10 +1453,12 @@ void chpl_comm_getput_unordered(c_nodeid_t dstnode, void* dstaddr,
   }
 
   if (dstnode == chpl_nodeID) {
-    chpl_comm_get(dstaddr, srcnode, srcaddr, size, commID, ln, fn);
+    chpl_comm_get_unordered(dstaddr, srcnode, srcaddr, size, commID, ln, fn);
   } else if (srcnode == chpl_nodeID) {
-    chpl_comm_put(srcaddr, dstnode, dstaddr, size, commID, ln, fn);
+    chpl_comm_put_unordered(srcaddr, dstnode, dstaddr, size, commID, ln, fn);
   } else {
+    // TODO use unordered ops in this case? Would have to ensure we always
+    // sync the GET before starting the PUT
     if (size <= MAX_UNORDERED_TRANS_SZ) {
       char buf[MAX_UNORDERED_TRANS_SZ];
       chpl_comm_get(buf, srcnode, srcaddr, size, commID, ln, fn);
@@ -1373,15 +1476,235 @@ void chpl_comm_getput_unordered(c_nodeid_t dstnode, void* dstaddr,
 
 void chpl_comm_get_unordered(void* addr, c_nodeid_t node, void* raddr,
                              size_t size, int32_t commID, int ln, int32_t fn) {
-  chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
+  unordered_buff_task_info_t* info;
+  int remote_in_segment;
+
+  if (chpl_nodeID == node) {
+    memmove(addr, raddr, size);
+    return;
+  }
+
+#ifdef GASNET_SEGMENT_EVERYTHING
+  remote_in_segment = 1;
+#else
+  remote_in_segment = chpl_comm_addr_gettable(node, raddr, size);
+#endif
+
+  if (!remote_in_segment || (info = unordered_buff_acquire()) == NULL) {
+    chpl_comm_get(addr, node, raddr, size, commID, ln, fn);
+    return;
+  }
+
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_get)) {
+    chpl_comm_cb_info_t cb_data =
+      {chpl_comm_cb_event_kind_get, chpl_nodeID, node,
+       .iu.comm={addr, raddr, size, commID, ln, fn}};
+    chpl_comm_do_callbacks (&cb_data);
+  }
+
+  chpl_comm_diags_verbose_rdma("unordered get", node, size, ln, fn, commID);
+  chpl_comm_diags_incr(get);
+
+  unordered_buff_add(info, gasnet_get_nb_bulk(addr, node, raddr, size));
 }
 
 void chpl_comm_put_unordered(void* addr, c_nodeid_t node, void* raddr,
                              size_t size, int32_t commID, int ln, int32_t fn) {
-  chpl_comm_put(addr, node, raddr, size, commID, ln, fn);
+  unordered_buff_task_info_t* info;
+  int remote_in_segment;
+
+  if (chpl_nodeID == node) {
+    memmove(raddr, addr, size);
+    return;
+  }
+
+#ifdef GASNET_SEGMENT_EVERYTHING
+  remote_in_segment = 1;
+#else
+  remote_in_segment = chpl_comm_addr_gettable(node, raddr, size);
+#endif
+
+  if (!remote_in_segment || (info = unordered_buff_acquire()) == NULL) {
+    chpl_comm_put(addr, node, raddr, size, commID, ln, fn);
+    return;
+  }
+
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_put)) {
+    chpl_comm_cb_info_t cb_data =
+      {chpl_comm_cb_event_kind_put, chpl_nodeID, node,
+       .iu.comm={addr, raddr, size, commID, ln, fn}};
+    chpl_comm_do_callbacks (&cb_data);
+  }
+
+  chpl_comm_diags_verbose_rdma("unordered put", node, size, ln, fn, commID);
+  chpl_comm_diags_incr(put);
+
+  // The source may be reused once a non-bulk put has been started.
+  unordered_buff_add(info, gasnet_put_nb(node, raddr, addr, size));
+}
+
+void chpl_comm_getput_unordered_task_fence(void) {
+  chpl_comm_taskPrvData_t* prvData = get_comm_taskPrvdata();
+  if (prvData != NULL && prvData->unordered_buff != NULL)
+    unordered_buff_flush(prvData->unordered_buff);
+}
+
+//
+// Coalescing of non-blocking small forks
+//
+// A coforall or loop that starts many small `begin on`s would otherwise
+// send one AM for each.  When CHPL_RT_COMM_FORK_BATCH_SIZE is greater
+// than 1, non-blocking small forks are instead appended to a buffer for
+// their target node, which is sent as a single FORK_NB_BATCH AM once it
+// holds that many forks or runs out of room.  The polling task sends
+// any buffer whose oldest fork has waited longer than
+// CHPL_RT_COMM_FORK_BATCH_USECS, so a fork is never held indefinitely
+// by a task that goes on to wait for it.
+//
+#define FORK_BATCH_BUF_SIZE 4096
+
+typedef struct {
+  pthread_mutex_t lock;
+  int count;            // number of forks in the buffer
+  size_t used;          // bytes used in the buffer
+  uint64_t t_first;     // when the first of them was added, in ns
+  uint64_t* buf;        // the buffer, allocated on first use
+} fork_batch_t;
+
+static int fork_batch_max;              // max forks per batch; <2 is off
+static uint64_t fork_batch_max_wait_ns; // max ns a fork may be held
+static size_t fork_batch_buf_size;      // bytes per batch buffer
+static fork_batch_t* fork_batches;      // per-node batch buffers
+static atomic_int_least32_t fork_batches_pending; // # non-empty buffers
+
+static inline
+uint64_t fork_batch_now_ns(void) {
+  return gasnett_ticks_to_ns(gasnett_ticks_now());
+}
+
+static
+void init_fork_batches(void) {
+  fork_batch_max = chpl_env_rt_get_int("COMM_FORK_BATCH_SIZE", 0);
+  fork_batch_max_wait_ns =
+    1000 * (uint64_t) chpl_env_rt_get_int("COMM_FORK_BATCH_USECS", 50);
+
+  fork_batch_buf_size = FORK_BATCH_BUF_SIZE;
+  if (fork_batch_buf_size > gasnet_AMMaxMedium())
+    fork_batch_buf_size = gasnet_AMMaxMedium() & ~(size_t) 7;
+
+  atomic_init_int_least32_t(&fork_batches_pending, 0);
+
+  if (fork_batch_max < 2 || chpl_numNodes < 2) {
+    fork_batch_max = 0;
+    return;
+  }
+
+  fork_batches = chpl_mem_allocManyZero(chpl_numNodes, sizeof(fork_batch_t),
+                                        CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  for (int i = 0; i < chpl_numNodes; i++)
+    pthread_mutex_init(&fork_batches[i].lock, NULL);
+
+  // The polling task is what bounds the time a fork can be held.
+  pollingRequired = true;
 }
 
-void chpl_comm_getput_unordered_task_fence(void) { }
+// Send the batch for the given node, if it has anything in it.
+// With 'expired_only', only send it if it has been held too long.
+static
+void fork_batch_flush(c_nodeid_t node, chpl_bool expired_only) {
+  fork_batch_t* b = &fork_batches[node];
+  uint64_t msg[FORK_BATCH_BUF_SIZE / sizeof(uint64_t)];
+  size_t nbytes = 0;
+
+  if (*(volatile int*) &b->count == 0)
+    return;
+
+  pthread_mutex_lock(&b->lock);
+  if (b->count > 0
+      && (!expired_only
+          || fork_batch_now_ns() - b->t_first >= fork_batch_max_wait_ns)) {
+    nbytes = b->used;
+    memcpy(msg, b->buf, nbytes);
+    b->count = 0;
+    b->used = 0;
+    (void) atomic_fetch_sub_int_least32_t(&fork_batches_pending, 1);
+  }
+  pthread_mutex_unlock(&b->lock);
+
+  if (nbytes > 0) {
+    chpl_comm_diags_incr(execute_on_nb_batch);
+    GASNET_Safe(gasnet_AMRequestMedium0(node, FORK_NB_BATCH, msg, nbytes));
+  }
+}
+
+static
+void fork_batch_flush_expired(void) {
+  if (fork_batch_max == 0
+      || atomic_load_int_least32_t(&fork_batches_pending) == 0)
+    return;
+
+  for (c_nodeid_t node = 0; node < chpl_numNodes; node++)
+    fork_batch_flush(node, true);
+}
+
+static
+void fork_batch_flush_all(void) {
+  if (fork_batch_max == 0)
+    return;
+
+  for (c_nodeid_t node = 0; node < chpl_numNodes; node++)
+    fork_batch_flush(node, false);
+}
+
+// Add a small fork message to the batch for the given node.  Returns
+// false if it can't be batched and must be sent by itself.
+static
+chpl_bool fork_batch_add(c_nodeid_t node, small_fork_hdr_t* f, size_t nbytes) {
+  fork_batch_t* b = &fork_batches[node];
+  size_t need = FORK_BATCH_ENTRY_SIZE(nbytes);
+  chpl_bool full;
+
+  if (need > fork_batch_buf_size)
+    return false;
+
+  while (1) {
+    pthread_mutex_lock(&b->lock);
+    if (b->used + need <= fork_batch_buf_size)
+      break;
+    pthread_mutex_unlock(&b->lock);
+    fork_batch_flush(node, false);
+  }
+
+  if (b->buf == NULL) {
+    b->buf = chpl_mem_alloc(fork_batch_buf_size,
+                            CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  }
+
+  if (b->count == 0) {
+    b->t_first = fork_batch_now_ns();
+    (void) atomic_fetch_add_int_least32_t(&fork_batches_pending, 1);
+  }
+
+  {
+    fork_batch_entry_t* e = (fork_batch_entry_t*) ((char*) b->buf + b->used);
+    e->nbytes = nbytes;
+    memcpy(e + 1, f, nbytes);
+  }
+
+  b->used += need;
+  b->count++;
+  full = (b->count >= fork_batch_max
+          || b->used + FORK_BATCH_ENTRY_SIZE(sizeof(small_fork_hdr_t))
+             > fork_batch_buf_size);
+  pthread_mutex_unlock(&b->lock);
+
+  if (full)
+    fork_batch_flush(node, false);
+
+  return true;
+}
 
 static inline
 void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
@@ -1449,8 +1772,11 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
       // Copy in the payload
       memcpy(f + 1, arg + 1, payload_size);
     
-      // Send the AM
-      GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, small_msg_size));
+      // Send the AM, or add it to a batch if we're coalescing forks
+      if (op != FORK_NB_SMALL
+          || fork_batch_max == 0
+          || !fork_batch_add(node, f, small_msg_size))
+        GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, small_msg_size));
     } else {
       // Setup a small message pointing to arg
       // so the other side can GET from it
@@ -1571,4 +1897,11 @@ void  chpl_comm_execute_on_fast(c_nodeid_t node, c_sublocid_t subloc,
   }
 }
 
-void chpl_comm_task_end(void) { }
+void chpl_comm_task_end(void) {
+  chpl_comm_taskPrvData_t* prvData = get_comm_taskPrvdata();
+  if (prvData != NULL && prvData->unordered_buff != NULL) {
+    unordered_buff_flush(prvData->unordered_buff);
+    chpl_mem_free(prvData->unordered_buff, 0, 0);
+    prvData->unordered_buff = NULL;
+  }
+}
@@ -426,6 +426,7 @@ static void init_ofiForRma(void);
 static void init_ofiForAms(void);
 
 static void init_bar(void);
+static void init_amoAgg(void);
 
 static void init_broadcast_private(void);
 
@@ -485,6 +486,7 @@ void init_ofi(void) {
   init_ofiForMem();
   init_ofiForRma();
   init_ofiForAms();
+  init_amoAgg();
 
   DBG_PRINTF(DBG_CFG,
              "AM config: recv buf size %zd MiB, %s, responses use %s",
@@ -1606,9 +1608,44 @@ typedef enum {
   am_opGet,                             // do an RMA GET
   am_opPut,                             // do an RMA PUT
   am_opAMO,                             // do an AMO
+  am_opAMOBatch,                        // do a batch of unordered AMOs
   am_opShutdown,                        // signal main process for shutdown
 } amOp_t;
 
+//
+// An am_opAMOBatch request is a bundle followed by the AMOs themselves.
+// These are always non-fetching, so only one operand is needed.
+//
+typedef struct {
+  void* obj;                    // object address on target node
+  chpl_amo_datum_t operand;     // operand
+  uint8_t ofiOp;                // ofi AMO op (enum fi_op)
+  uint8_t ofiType;              // ofi object type (enum fi_datatype)
+  int8_t size;                  // object size (bytes)
+} amoBatchEntry_t;
+
+#define AMO_BATCH_MAX_LEN                                               \
+  ((int) ((AM_MAX_MSG_SIZE - sizeof(chpl_comm_on_bundle_t))             \
+          / sizeof(amoBatchEntry_t)))
+
+typedef struct {
+  chpl_comm_on_bundle_t hdr;
+  amoBatchEntry_t ents[AMO_BATCH_MAX_LEN];
+} amoBatchMsg_t;
+
+//
+// Each task collects its unordered AMOs for a given node in one of a
+// small number of buffers, chosen by node number.
+//
+#define AMO_AGG_NUM_BUFS 8
+
+typedef struct {
+  c_nodeid_t node;              // target node
+  int count;                    // number of AMOs collected
+  double tFirst;                // when the first of them was collected
+  amoBatchMsg_t msg;
+} amoAggBuf_t;
+
 #ifdef CHPL_COMM_DEBUG
 static const char* am_opName(amOp_t);
 static const char* amo_opName(enum fi_op);
@@ -1621,8 +1658,10 @@ static void amRequestExecOn(c_nodeid_t, c_sublocid_t, chpl_fn_int_t,
 static void amRequestRMA(c_nodeid_t, amOp_t, void*, void*, size_t);
 static void amRequestAMO(c_nodeid_t, void*, const void*, const void*, void*,
                          int, enum fi_datatype, size_t);
+static void amRequestAMOBatch(c_nodeid_t, amoBatchMsg_t*, int);
 static void amRequestCommon(c_nodeid_t, chpl_comm_on_bundle_t*, size_t,
                             chpl_comm_amDone_t**, chpl_bool, chpl_bool);
+static void amoAggFlushAll(amoAggBuf_t*);
 
 
 static inline
@@ -1639,7 +1678,17 @@ void ensure_progress(void) {
 }
 
 
-void chpl_comm_task_end(void) { }
+void chpl_comm_task_end(void) {
+  //
+  // Send along any unordered AMOs this task has been collecting.
+  //
+  chpl_task_prvData_t* task_prvData = chpl_task_getPrvData();
+  if (task_prvData != NULL && task_prvData->comm_data.amoAggBufs != NULL) {
+    amoAggFlushAll(task_prvData->comm_data.amoAggBufs);
+    CHPL_FREE(task_prvData->comm_data.amoAggBufs);
+    task_prvData->comm_data.amoAggBufs = NULL;
+  }
+}
 
 
 void chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
@@ -1833,6 +1882,23 @@ void amRequestAMO(c_nodeid_t node, void* object,
   }
 }
 
+static inline
+void amRequestAMOBatch(c_nodeid_t node, amoBatchMsg_t* msg, int count) {
+  DBG_PRINTF(DBG_AMO, "AMO batch via AM: node %d, count %d",
+             (int) node, count);
+
+  msg->hdr.comm.amoBatch = (struct chpl_comm_bundleData_AMOBatch_t)
+                             { .b = (struct chpl_comm_bundleData_base_t)
+                                    { .op = am_opAMOBatch,
+                                      .node = chpl_nodeID },
+                               .count = count,
+                               .pAmDone = NULL };
+  amRequestCommon(node, &msg->hdr,
+                  (offsetof(amoBatchMsg_t, ents)
+                   + count * sizeof(msg->ents[0])),
+                  &msg->hdr.comm.amoBatch.pAmDone, false, true);
+}
+
 static inline
 void amRequestShutdown(c_nodeid_t node) {
   chpl_comm_on_bundle_t arg;
@@ -2002,6 +2068,7 @@ static void amWrapExecOnLrgBody(void*);
 static void amWrapGet(void*);
 static void amWrapPut(void*);
 static void amHandleAMO(struct perTxCtxInfo_t*, chpl_comm_on_bundle_t*);
+static void amHandleAMOBatch(chpl_comm_on_bundle_t*);
 static inline void amSendDone(struct chpl_comm_bundleData_base_t*,
                               chpl_comm_amDone_t*);
 
@@ -2186,6 +2253,10 @@ void processRxAmReq(struct perTxCtxInfo_t* tcip) {
         amHandleAMO(tcip, req);
         break;
 
+      case am_opAMOBatch:
+        amHandleAMOBatch(req);
+        break;
+
       case am_opShutdown:
         chpl_signal_shutdown();
         break;
@@ -2244,6 +2315,12 @@ void amWrapExecOnBody(void* p) {
 
   chpl_ftable_call(xo->fid, p);
   if (xo->pAmDone != NULL) {
+    //
+    // The compiler doesn't end the body of a blocking executeOn the way
+    // it does for other tasks, so send along any unordered AMOs the body
+    // collected before telling the initiator we're done.
+    //
+    chpl_comm_task_end();
     amSendDone(&xo->b, xo->pAmDone);
   } else {
     DBG_PRINTF(DBG_AM | DBG_AMRECV,
@@ -2321,6 +2398,7 @@ void amWrapExecOnLrgBody(void* p) {
   //
   chpl_ftable_call(xol->fid, req);
   if (xol->pAmDone != NULL) {
+    chpl_comm_task_end(); // see amWrapExecOnBody()
     amSendDone(&xol->b, xol->pAmDone);
   } else {
     DBG_PRINTF(DBG_AM | DBG_AMRECV,
@@ -2441,6 +2519,28 @@ void amHandleAMO(struct perTxCtxInfo_t* tcip, chpl_comm_on_bundle_t* req) {
 }
 
 
+static
+void amHandleAMOBatch(chpl_comm_on_bundle_t* req) {
+  struct chpl_comm_bundleData_AMOBatch_t* batch = &req->comm.amoBatch;
+  amoBatchEntry_t* ents = ((amoBatchMsg_t*) req)->ents;
+
+  DBG_PRINTF(DBG_AM | DBG_AMRECV | DBG_AMO,
+             "amHandleAMOBatch(seqId %d:%" PRIu64 "): count %d",
+             (int) batch->b.node, batch->b.seq, (int) batch->count);
+
+  for (int i = 0; i < batch->count; i++) {
+    doCpuAMO(ents[i].obj, &ents[i].operand, NULL, NULL,
+             ents[i].ofiOp, ents[i].ofiType, ents[i].size);
+  }
+
+  //
+  // The initiator is never this node; unordered AMOs on local objects
+  // are done directly rather than being collected.
+  //
+  amSendDone(&batch->b, batch->pAmDone);
+}
+
+
 static inline
 void amSendDone(struct chpl_comm_bundleData_base_t* b,
                 chpl_comm_amDone_t* pAmDone) {
@@ -3303,6 +3403,8 @@ void local_yield(void) {
 
 static inline void doAMO(c_nodeid_t, void*, const void*, const void*, void*,
                          int, enum fi_datatype, size_t);
+static inline void doAMOUnordered(c_nodeid_t, void*, const void*,
+                                  int, enum fi_datatype, size_t);
 
 
 //
@@ -3422,8 +3524,10 @@ DEFN_CHPL_COMM_ATOMIC_CMPXCHG(real64, FI_DOUBLE, double)
                "chpl_comm_atomic_%s_unordered_%s(<%s>, %d, %p, %d, %s)",\
                #fnOp, #fnType, DBG_VAL(operand, ofiType), (int) node,   \
                object, ln, chpl_lookupFilename(fn));                    \
-    chpl_comm_atomic_##fnOp##_##fnType(operand, node, object,           \
-                                       memory_order_seq_cst, ln, fn);   \
+    chpl_comm_diags_verbose_amo("amo unord_" #fnOp, node, ln, fn);      \
+    chpl_comm_diags_incr(amo);                                          \
+    doAMOUnordered(node, object, operand,                               \
+                   ofiOp, ofiType, sizeof(Type));                       \
   }                                                                     \
                                                                         \
   void chpl_comm_atomic_fetch_##fnOp##_##fnType                         \
@@ -3486,8 +3590,11 @@ DEFN_IFACE_AMO_SIMPLE_OP(add, FI_SUM, real64, FI_DOUBLE, double)
                "%d, %s)",                                               \
                #fnType, DBG_VAL(operand, ofiType), (int) node, object,  \
                ln, chpl_lookupFilename(fn));                            \
-    chpl_comm_atomic_sub_##fnType(operand, node, object,                \
-                                  memory_order_seq_cst, ln, fn);        \
+    Type myOpnd = negate(*(Type*) operand);                             \
+    chpl_comm_diags_verbose_amo("amo unord_sub", node, ln, fn);         \
+    chpl_comm_diags_incr(amo);                                          \
+    doAMOUnordered(node, object, &myOpnd,                               \
+                   FI_SUM, ofiType, sizeof(Type));                      \
   }                                                                     \
                                                                         \
   void chpl_comm_atomic_fetch_sub_##fnType                              \
@@ -3517,7 +3624,12 @@ DEFN_IFACE_AMO_SUB(real32, FI_FLOAT, float, NEGATE_U_OR_R)
 DEFN_IFACE_AMO_SUB(real64, FI_DOUBLE, double, NEGATE_U_OR_R)
 
 void chpl_comm_atomic_unordered_task_fence(void) {
-  return;
+  DBG_PRINTF(DBG_INTERFACE, "chpl_comm_atomic_unordered_task_fence()");
+
+  chpl_task_prvData_t* task_prvData = chpl_task_getPrvData();
+  if (task_prvData != NULL && task_prvData->comm_data.amoAggBufs != NULL) {
+    amoAggFlushAll(task_prvData->comm_data.amoAggBufs);
+  }
 }
 
 
@@ -3637,6 +3749,130 @@ void doAMO(c_nodeid_t node, void* object,
 }
 
 
+//
+// Unordered AMOs
+//
+// Unordered AMOs that can be done natively are done the same way as
+// ordered ones.  But those that have to be done by the target node's
+// CPU would each cost an AM round trip, so instead we collect them in
+// per-task, per-node buffers and send each buffer as a single batch AM
+// whose handler does all the AMOs in it.  A buffer is sent when it is
+// full, when the oldest AMO in it has waited longer than the
+// aggregation timeout (checked whenever the task does another unordered
+// AMO), when the task needs the buffer for a different node, and at the
+// unordered AMO task fence and task end.  Blocking executeOn bodies and
+// the main task don't reach the usual task end hook, so their buffers
+// are flushed when the body returns and in the post-user-code hook,
+// respectively.
+//
+static int amoAggMaxLen;                // max AMOs per batch; <2 means off
+static double amoAggTimeout;            // max secs an AMO may be held
+
+static
+void init_amoAgg(void) {
+  amoAggMaxLen = chpl_env_rt_get_int("COMM_OFI_AMO_AGG_LEN",
+                                     AMO_BATCH_MAX_LEN);
+  if (amoAggMaxLen > AMO_BATCH_MAX_LEN) {
+    amoAggMaxLen = AMO_BATCH_MAX_LEN;
+  }
+  amoAggTimeout = 1.0e-6 * chpl_env_rt_get_int("COMM_OFI_AMO_AGG_USECS",
+                                               1000);
+
+  DBG_PRINTF(DBG_CFG,
+             "unordered AMO aggregation: max %d per batch, timeout %g sec",
+             amoAggMaxLen, amoAggTimeout);
+}
+
+
+static inline
+void amoAggFlush(amoAggBuf_t* buf) {
+  if (buf->count > 0) {
+    amRequestAMOBatch(buf->node, &buf->msg, buf->count);
+    buf->count = 0;
+  }
+}
+
+
+static
+void amoAggFlushAll(amoAggBuf_t* bufs) {
+  for (int i = 0; i < AMO_AGG_NUM_BUFS; i++) {
+    amoAggFlush(&bufs[i]);
+  }
+}
+
+
+static inline
+void amoAggAdd(chpl_comm_taskPrvData_t* prvData,
+               c_nodeid_t node, void* object, const void* operand,
+               int ofiOp, enum fi_datatype ofiType, size_t size) {
+  if (prvData->amoAggBufs == NULL) {
+    amoAggBuf_t* newBufs;
+    CHPL_CALLOC(newBufs, AMO_AGG_NUM_BUFS);
+    prvData->amoAggBufs = newBufs;
+  }
+
+  amoAggBuf_t* bufs = prvData->amoAggBufs;
+  amoAggBuf_t* buf = &bufs[node % AMO_AGG_NUM_BUFS];
+  const double now = chpl_comm_ofi_time_get();
+
+  if (buf->count > 0 && buf->node != node) {
+    amoAggFlush(buf);
+  }
+
+  if (buf->count == 0) {
+    buf->node = node;
+    buf->tFirst = now;
+  }
+
+  amoBatchEntry_t* ent = &buf->msg.ents[buf->count++];
+  ent->obj = object;
+  memcpy(&ent->operand, operand, size);
+  ent->ofiOp = ofiOp;
+  ent->ofiType = ofiType;
+  ent->size = size;
+
+  DBG_PRINTF(DBG_AMO,
+             "AMO collected: obj %d:%p, opnd <%s>, op %s, typ %s, sz %zd, "
+             "count %d",
+             (int) node, object, DBG_VAL(operand, ofiType),
+             amo_opName(ofiOp), amo_typeName(ofiType), size, buf->count);
+
+  if (buf->count >= amoAggMaxLen) {
+    amoAggFlush(buf);
+  }
+
+  for (int i = 0; i < AMO_AGG_NUM_BUFS; i++) {
+    if (bufs[i].count > 0 && now - bufs[i].tFirst >= amoAggTimeout) {
+      amoAggFlush(&bufs[i]);
+    }
+  }
+}
+
+
+static inline
+void doAMOUnordered(c_nodeid_t node, void* object, const void* operand,
+                    int ofiOp, enum fi_datatype ofiType, size_t size) {
+  //
+  // Collect this AMO if it would otherwise be done via an AM.  The AM
+  // handler has no task end at which to send its collected AMOs, so it
+  // doesn't collect them.
+  //
+  chpl_task_prvData_t* task_prvData;
+  if (chpl_numNodes > 1
+      && node != chpl_nodeID
+      && amoAggMaxLen > 1
+      && !isAmHandler
+      && (task_prvData = chpl_task_getPrvData()) != NULL
+      && !(isAtomicValid(ofiType)
+           && mrGetKey(NULL, NULL, node, object, size) == 0)) {
+    amoAggAdd(&task_prvData->comm_data, node, object, operand,
+              ofiOp, ofiType, size);
+  } else {
+    doAMO(node, object, operand, NULL, NULL, ofiOp, ofiType, size);
+  }
+}
+
+
 static inline
 void doCpuAMO(void* obj,
               const void* operand1, const void* operand2, void* result,
@@ -4247,6 +4483,7 @@ const char* am_opName(amOp_t op) {
   case am_opGet: return "opGet";
   case am_opPut: return "opPut";
   case am_opAMO: return "opAMO";
+  case am_opAMOBatch: return "opAMOBatch";
   case am_opShutdown: return "opShutdown";
   default: return "op???";
   }
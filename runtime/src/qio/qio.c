@@ -38,6 +38,7 @@
 #include "qio.h"
 #include "qbuffer.h"
 #include "qio_plugin_api.h"
+#include "qio_async.h"
 
 #include "error.h"
 
@@ -549,6 +550,9 @@ qio_hint_t choose_io_method(qio_file_t* file, qio_hint_t hints, qio_hint_t defau
             mmap_ok = true;
           if (hints & QIO_HINT_NOREUSE)
             mmap_ok = false;
+          // mmap can't do asynchronous read-ahead or write-behind
+          if ((ret & QIO_HINT_ASYNC) && file->mmap == NULL)
+            mmap_ok = false;
 
           if (mmap_ok)
             method = QIO_METHOD_MMAP;
@@ -578,6 +582,13 @@ qio_hint_t choose_io_method(qio_file_t* file, qio_hint_t hints, qio_hint_t defau
     // type is O.K.
   }
 
+  // Asynchronous I/O is only implemented with pread/pwrite,
+  // and it is not compatible with O_DIRECT alignment.
+  if( method != QIO_METHOD_PREADPWRITE || file->file_info ||
+      (ret & QIO_HINT_DIRECT) ) {
+    ret &= ~QIO_HINT_ASYNC;
+  }
+
   return ret | method | type;
 }
 
@@ -1370,6 +1381,12 @@ qioerr _qio_channel_init_file_internal(qio_channel_t* ch, qio_file_t* file, qio_
     ch->flags = (qio_fdflag_t) (ch->flags & ~QIO_FDFLAG_WRITEABLE);
   }
 
+  // Read-ahead could miss what the channel writes, so only
+  // use asynchronous I/O for channels that read or write.
+  if( readable && writeable ) {
+    ch->hints &= ~QIO_HINT_ASYNC;
+  }
+
   ch->start_pos = start;
   ch->end_pos = end;
 
@@ -1711,6 +1728,40 @@ qioerr qio_channel_path_offset(const int threadsafe, qio_channel_t* ch, const ch
   return err;
 }
 
+// Waits for the oldest asynchronous request, removes it from the
+// channel and returns it. The caller must call qio_async_free.
+static
+qio_async_req_t* _qio_async_pop(qio_channel_t* ch)
+{
+  qio_async_req_t* req = ch->async_head;
+
+  qio_async_wait(req);
+
+  ch->async_head = req->next;
+  if( ch->async_head == NULL ) ch->async_tail = NULL;
+  ch->async_count--;
+
+  // Remember any error from writing in the background
+  if( req->writing && ! ch->async_err ) {
+    if( req->err ) ch->async_err = req->err;
+    else if( req->num_done < req->len ) ch->async_err = QIO_ESHORT;
+  }
+
+  return req;
+}
+
+// Waits for all asynchronous requests and frees them. Unused
+// read-ahead is discarded. Returns any error from writing.
+static
+qioerr _qio_async_drain(qio_channel_t* ch)
+{
+  while( ch->async_head ) {
+    qio_async_free(_qio_async_pop(ch));
+  }
+
+  return ch->async_err;
+}
+
 qioerr _qio_channel_final_flush_unlocked(qio_channel_t* ch)
 {
   qioerr err = 0;
@@ -1735,6 +1786,14 @@ qioerr _qio_channel_final_flush_unlocked(qio_channel_t* ch)
         " please close all writing channels before closing the file");
 
   err = _qio_channel_flush_unlocked(ch);
+
+  // Background requests use the file and might still be running
+  // if the flush failed (or if this channel was reading).
+  if( ch->async_head ) {
+    qioerr async_err = _qio_async_drain(ch);
+    if( ! err ) err = async_err;
+  }
+
   if( ! err ) {
     // If we have a buffered writing MMAP channel, we need to truncate
     // the file under the right circumstances. See the comment
@@ -2197,6 +2256,102 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
   else return 0;
 }
 
+// Keeps up to qio_async_max_depth() iobuf-sized reads in flight,
+// continuing from the last one (or from av_end), up to end_pos.
+static
+void _qio_async_read_ahead(qio_channel_t* ch)
+{
+  int64_t depth = qio_async_max_depth();
+  int64_t next;
+  int64_t len;
+  qbytes_t* bytes;
+  qio_async_req_t* req;
+  qioerr err;
+
+  if( ch->async_tail ) next = ch->async_tail->offset + ch->async_tail->len;
+  else next = ch->av_end;
+
+  while( ch->async_count < depth && next < ch->end_pos ) {
+    len = qbytes_iobuf_size;
+    if( ch->end_pos - next < len ) len = ch->end_pos - next;
+
+    err = qbytes_create_iobuf(&bytes);
+    if( err ) break;
+
+    err = qio_async_submit(ch->file->fd, 0, bytes, 0, len, next, &req);
+    qbytes_release(bytes); // the request retains it
+    if( err ) break;
+
+    if( ch->async_tail ) ch->async_tail->next = req;
+    else ch->async_head = req;
+    ch->async_tail = req;
+    ch->async_count++;
+
+    next += len;
+  }
+}
+
+// Appends completed read-ahead to the buffer until amt bytes
+// have been added (or EOF), and then issues more read-ahead.
+// Sets *got to the number of bytes added; if that is less than amt
+// without an error, the caller should read the rest itself.
+static
+qioerr _buffered_read_async(qio_channel_t* ch, int64_t amt, int64_t* got)
+{
+  qio_async_req_t* req;
+  int64_t extra;
+  int64_t num;
+  qioerr err = 0;
+
+  *got = 0;
+
+  // Remove any space allocated but not read so that
+  // the read-ahead can be appended at av_end.
+  extra = qbuffer_end_offset(&ch->buf) - ch->av_end;
+  if( extra > 0 ) qbuffer_trim_back(&ch->buf, extra);
+
+  // Read-ahead for some other position (after a seek) is of no use.
+  if( ch->async_head && ch->async_head->offset != ch->av_end ) {
+    _qio_async_drain(ch);
+  }
+
+  while( 1 ) {
+    _qio_async_read_ahead(ch);
+
+    if( *got >= amt || ! ch->async_head ) break;
+
+    req = _qio_async_pop(ch);
+    num = req->num_done;
+    err = req->err;
+    // The request might have been made before a seek reduced end_pos.
+    if( num > ch->end_pos - ch->av_end ) {
+      num = ch->end_pos - ch->av_end;
+      if( num < 0 ) num = 0;
+    }
+    if( num > 0 ) {
+      qioerr append_err = qbuffer_append(&ch->buf, req->bytes, 0, num);
+      if( append_err ) {
+        err = append_err;
+      } else {
+        ch->av_end += num;
+        *got += num;
+      }
+    }
+    qio_async_free(req);
+
+    // Reads only stop short with an error, including EOF.
+    if( err ) break;
+  }
+
+  if( err ) {
+    // Anything read ahead is past EOF (or after the error)
+    _qio_async_drain(ch);
+    if( qio_err_to_int(err) == EEOF && *got >= amt ) err = 0;
+  }
+
+  return err;
+}
+
 // Runs read or pread, whichever is appropriate,
 // to read into the buffer.
 static
@@ -2230,6 +2385,19 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
     return chpl_qio_read_atleast(ch->chan_info, amt);
   }
 
+  if( ch->hints & QIO_HINT_ASYNC ) {
+    int64_t got = 0;
+    err = _buffered_read_async(ch, amt, &got);
+    if( err ) return err;
+    amt -= got;
+    max_amt -= got;
+    if( amt <= 0 ) {
+      if( return_eof ) return QIO_EEOF;
+      else return 0;
+    }
+    // Otherwise, read the rest ourselves.
+  }
+
   //printf("Allocating bufferspace %lli\n", (long long int) amt);
   err = _buffered_allocate_bufferspace(ch, amt, max_amt);
   if( err ) return err;
@@ -2599,6 +2767,54 @@ void _qio_buffered_setup_cached(qio_channel_t* ch)
 }
 
 
+// Hands the buffer parts in [*write_start, write_end) to the
+// asynchronous I/O threads, advancing *write_start past them, while
+// keeping at most qio_async_max_depth() writes in flight. The parts
+// are retained by the requests, so the caller can trim them from
+// the buffer right away. If flushall is set, waits for all of them.
+static
+qioerr _qio_async_write_behind(qio_channel_t* ch,
+                               qbuffer_iter_t* write_start,
+                               qbuffer_iter_t write_end,
+                               int flushall)
+{
+  int64_t depth = qio_async_max_depth();
+  qbytes_t* bytes;
+  int64_t skip;
+  int64_t len;
+  qio_async_req_t* req;
+  qioerr err;
+
+  // Report an error from an earlier background write.
+  if( ch->async_err ) return ch->async_err;
+
+  while( qbuffer_iter_num_bytes(*write_start, write_end) > 0 ) {
+    qbuffer_iter_get(*write_start, write_end, &bytes, &skip, &len);
+    if( len <= 0 ) break;
+
+    if( ch->async_count >= depth ) {
+      qio_async_free(_qio_async_pop(ch));
+      if( ch->async_err ) return ch->async_err;
+    }
+
+    err = qio_async_submit(ch->file->fd, 1, bytes, skip, len,
+                           write_start->offset, &req);
+    // If that didn't work, the caller writes the rest itself.
+    if( err ) break;
+
+    if( ch->async_tail ) ch->async_tail->next = req;
+    else ch->async_head = req;
+    ch->async_tail = req;
+    ch->async_count++;
+
+    qbuffer_iter_advance(&ch->buf, write_start, len);
+  }
+
+  if( flushall ) return _qio_async_drain(ch);
+
+  return 0;
+}
+
 // Writes chunks that are complete. If flushall is set,
 // also writes an incomplete portion of a chunk.
 //
@@ -2647,6 +2863,11 @@ qioerr _qio_buffered_behind(qio_channel_t* ch, int flushall)
 
   if (nbytes == 0) {
     err = 0;
+    // Still wait for any writes going on in the background.
+    if( flushall && (ch->hints & QIO_HINT_ASYNC) &&
+        (ch->flags & QIO_FDFLAG_WRITEABLE) ) {
+      err = _qio_async_drain(ch);
+    }
     goto done;
   }
 
@@ -2663,6 +2884,11 @@ qioerr _qio_buffered_behind(qio_channel_t* ch, int flushall)
   }
 
   if(ch->flags & QIO_FDFLAG_WRITEABLE) {
+    if( ch->hints & QIO_HINT_ASYNC ) {
+      err = _qio_async_write_behind(ch, &write_start, write_end, flushall);
+      if( err ) goto error;
+    }
+
     while( qbuffer_iter_num_bytes(write_start, write_end) > 0 ) {
       QIO_GET_CONSTANT_ERROR(err, EINVAL, "write method not implemented");
       num_written = 0;
@@ -3602,6 +3828,108 @@ qioerr qio_channel_advance_past_byte(const int threadsafe, qio_channel_t* ch, in
 }
 
 
+qioerr qio_channel_peek_through_byte(const int threadsafe, qio_channel_t* ch, int byte, uint8_t** scratch, int64_t* scratch_size, uint8_t** ptr_out, int64_t* len_out)
+{
+  qioerr err = 0;
+  int64_t searched = 0;
+  int found = 0;
+  qbuffer_iter_t start;
+  qbuffer_iter_t end;
+  qbuffer_iter_t cur;
+  qbytes_t* bytes;
+  int64_t skip;
+  int64_t len;
+
+  *ptr_out = NULL;
+  *len_out = 0;
+
+  if( threadsafe ) {
+    err = qio_lock(&ch->lock);
+    if( err ) {
+      return err;
+    }
+  }
+
+  // Fast path: the byte is in the cached region (which covers the
+  // whole mapping when a file is read with mmap).
+  if( qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) {
+    size_t cached_len = qio_ptr_diff(ch->cached_end, ch->cached_cur);
+    void* at = memchr(ch->cached_cur, byte, cached_len);
+    if( at != NULL ) {
+      *ptr_out = (uint8_t*) ch->cached_cur;
+      *len_out = qio_ptr_diff(at, ch->cached_cur) + 1;
+      goto done;
+    }
+  }
+
+  // Slow path: search the buffer from the current position, reading
+  // more data into it until we find the byte or reach EOF.
+  while( !found ) {
+    err = _qio_channel_require_unlocked(ch, searched + 1, false);
+    if( err && qio_err_to_int(err) != EEOF ) goto done;
+    err = 0;
+
+    if( ch->av_end - _right_mark_start(ch) <= searched ) {
+      // EOF; the rest of the data is the last item.
+      if( searched == 0 ) err = QIO_EEOF;
+      break;
+    }
+
+    end = _av_end_iter(ch);
+    cur = _right_mark_start_iter(ch);
+    qbuffer_iter_advance(&ch->buf, &cur, searched);
+    while( qbuffer_iter_num_bytes(cur, end) > 0 ) {
+      void* part;
+      void* at;
+      qbuffer_iter_get(cur, end, &bytes, &skip, &len);
+      part = qio_ptr_add(qbytes_data(bytes), skip);
+      at = memchr(part, byte, len);
+      if( at != NULL ) {
+        searched += qio_ptr_diff(at, part) + 1;
+        found = 1;
+        break;
+      }
+      searched += len;
+      qbuffer_iter_next_part(&ch->buf, &cur);
+    }
+  }
+  if( err ) goto done;
+
+  // Point into the buffer if the bytes are contiguous there,
+  // otherwise gather them into the scratch space.
+  start = _right_mark_start_iter(ch);
+  end = _av_end_iter(ch);
+  qbuffer_iter_get(start, end, &bytes, &skip, &len);
+  if( len >= searched ) {
+    *ptr_out = (uint8_t*) qio_ptr_add(qbytes_data(bytes), skip);
+  } else {
+    if( *scratch_size < searched ) {
+      uint8_t* grown = (uint8_t*) qio_realloc(*scratch, searched);
+      if( ! grown ) {
+        err = QIO_ENOMEM;
+        goto done;
+      }
+      *scratch = grown;
+      *scratch_size = searched;
+    }
+    end = start;
+    qbuffer_iter_advance(&ch->buf, &end, searched);
+    err = qbuffer_copyout(&ch->buf, start, end, *scratch, searched);
+    if( err ) goto done;
+    *ptr_out = *scratch;
+  }
+  *len_out = searched;
+
+done:
+  if( err && qio_err_to_int(err) != EEOF ) _qio_channel_set_error_unlocked(ch, err);
+  if( threadsafe ) {
+    qio_unlock(&ch->lock);
+  }
+
+  return err;
+}
+
+
 qioerr qio_channel_mark_maybe_flush_bits(const int threadsafe, qio_channel_t* ch, int flushbits)
 {
   qioerr err;
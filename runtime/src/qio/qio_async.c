@@ -0,0 +1,186 @@
+/*
+ * Copyright 2004-2020 Hewlett Packard Enterprise Development LP
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sys_basic.h"
+
+#ifndef CHPL_RT_UNIT_TEST
+#include "chplrt.h"
+#include "chpl-env.h"
+#endif
+
+#include "qio_async.h"
+
+#include <errno.h>
+#include <pthread.h>
+
+ssize_t qio_async_depth = 4; // iobufs in flight per channel (256K)
+ssize_t qio_async_threads = 2;
+
+// The pool threads are plain pthreads rather than Chapel tasks; like
+// qio_openproc, they only make system calls. They never allocate or
+// free memory: the submitting task does that, so the threads don't
+// need any Chapel runtime support.
+//
+// A task waiting for a request blocks its thread, just as it would
+// have if it had made the system call itself.
+
+static pthread_once_t qio_async_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t qio_async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t qio_async_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t qio_async_done = PTHREAD_COND_INITIALIZER;
+static qio_async_req_t* qio_async_head = NULL;
+static qio_async_req_t* qio_async_tail = NULL;
+static int qio_async_nthreads = 0; // how many actually started
+
+static
+void qio_async_do(qio_async_req_t* req)
+{
+  void* data = qio_ptr_add(req->bytes->data, req->skip);
+  int64_t done = 0;
+  ssize_t num;
+  err_t err = 0;
+
+  while( done < req->len ) {
+    num = 0;
+    if( req->writing ) {
+      err = sys_pwrite(req->fd, qio_ptr_add(data, done), req->len - done,
+                       req->offset + done, &num);
+    } else {
+      err = sys_pread(req->fd, qio_ptr_add(data, done), req->len - done,
+                      req->offset + done, &num);
+    }
+    if( num > 0 ) done += num;
+
+    // Ignore interrupted system call, just keep going.
+    if( err == EINTR ) err = 0;
+
+    if( err ) break;
+  }
+
+  req->num_done = done;
+  req->err = qio_int_to_err(err);
+}
+
+static
+void* qio_async_worker(void* arg)
+{
+  qio_async_req_t* req;
+
+  while( 1 ) {
+    pthread_mutex_lock(&qio_async_mutex);
+    while( qio_async_head == NULL ) {
+      pthread_cond_wait(&qio_async_work, &qio_async_mutex);
+    }
+    req = qio_async_head;
+    qio_async_head = req->next_queued;
+    if( qio_async_head == NULL ) qio_async_tail = NULL;
+    pthread_mutex_unlock(&qio_async_mutex);
+
+    qio_async_do(req);
+
+    pthread_mutex_lock(&qio_async_mutex);
+    req->done = 1;
+    pthread_cond_broadcast(&qio_async_done);
+    pthread_mutex_unlock(&qio_async_mutex);
+  }
+
+  return NULL;
+}
+
+static
+void qio_async_start(void)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int64_t i;
+
+#ifndef CHPL_RT_UNIT_TEST
+  qio_async_depth = chpl_env_rt_get_int("IO_ASYNC_DEPTH", qio_async_depth);
+  qio_async_threads = chpl_env_rt_get_int("IO_ASYNC_THREADS",
+                                          qio_async_threads);
+#endif
+
+  if( pthread_attr_init(&attr) ) return;
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  for( i = 0; i < qio_async_threads; i++ ) {
+    if( pthread_create(&thread, &attr, qio_async_worker, NULL) ) break;
+    qio_async_nthreads++;
+  }
+
+  pthread_attr_destroy(&attr);
+}
+
+int64_t qio_async_max_depth(void)
+{
+  pthread_once(&qio_async_once, qio_async_start);
+
+  if( qio_async_depth < 1 ) return 1;
+  return qio_async_depth;
+}
+
+qioerr qio_async_submit(fd_t fd, int writing, qbytes_t* bytes,
+                        int64_t skip, int64_t len, int64_t offset,
+                        qio_async_req_t** req_out)
+{
+  qio_async_req_t* req;
+
+  *req_out = NULL;
+
+  pthread_once(&qio_async_once, qio_async_start);
+
+  if( qio_async_nthreads == 0 )
+    QIO_RETURN_CONSTANT_ERROR(EAGAIN, "no threads for asynchronous I/O");
+
+  req = (qio_async_req_t*) qio_calloc(1, sizeof(qio_async_req_t));
+  if( ! req ) return QIO_ENOMEM;
+
+  qbytes_retain(bytes);
+  req->fd = fd;
+  req->writing = writing;
+  req->bytes = bytes;
+  req->skip = skip;
+  req->len = len;
+  req->offset = offset;
+
+  pthread_mutex_lock(&qio_async_mutex);
+  if( qio_async_tail ) qio_async_tail->next_queued = req;
+  else qio_async_head = req;
+  qio_async_tail = req;
+  pthread_cond_signal(&qio_async_work);
+  pthread_mutex_unlock(&qio_async_mutex);
+
+  *req_out = req;
+  return 0;
+}
+
+void qio_async_wait(qio_async_req_t* req)
+{
+  pthread_mutex_lock(&qio_async_mutex);
+  while( ! req->done ) {
+    pthread_cond_wait(&qio_async_done, &qio_async_mutex);
+  }
+  pthread_mutex_unlock(&qio_async_mutex);
+}
+
+void qio_async_free(qio_async_req_t* req)
+{
+  qbytes_release(req->bytes);
+  qio_free(req);
+}
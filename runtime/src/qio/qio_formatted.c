@@ -23,6 +23,7 @@
 #endif
 
 #include "qio_formatted.h"
+#include "qio_bytescan.h"
 
 #include <limits.h>
 #include <ctype.h>
@@ -170,15 +171,29 @@ qioerr _peek_until_byte(qio_channel_t* restrict ch, uint8_t term_byte, int64_t*
   err = qio_channel_mark(false, ch);
   if( err ) return err;
 
+  found_term = 0;
   while( 1 ) {
+    // Search whatever is in the fast path buffer with memchr
+    // instead of going through it a byte at a time.
+    if( qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) {
+      size_t len = qio_ptr_diff(ch->cached_end, ch->cached_cur);
+      void* found = memchr(ch->cached_cur, term_byte, len);
+      if( found != NULL ) {
+        ch->cached_cur = qio_ptr_add(found, 1);
+        found_term = 1;
+        break;
+      }
+      ch->cached_cur = ch->cached_end;
+      continue;
+    }
     err = qio_channel_read_uint8(false, ch, &byte);
     if( err ) break;
-    if( byte == term_byte ) break;
+    if( byte == term_byte ) {
+      found_term = 1;
+      break;
+    }
   }
 
-  if( byte == term_byte ) found_term = 1;
-  else found_term = 0;
-
   end_offset = qio_channel_offset_unlocked(ch);
 
   qio_channel_revert_unlocked(ch);
@@ -360,6 +375,61 @@ qioerr _append_char(char* restrict * restrict buf, size_t* restrict buf_len, siz
   return 0;
 }
 
+// Appends the run of plain ASCII bytes at the start of the fast path
+// buffer (see qio_scan_plain_ascii) to buf, up to max bytes, and
+// advances the channel past them.  Since each of those bytes is one
+// character, this is what reading and appending them one at a time
+// would do.  Stores the number of bytes appended in *amt_out.
+static
+qioerr _append_plain_run(qio_channel_t* restrict ch, char* restrict * restrict buf, size_t* restrict buf_len, size_t* restrict buf_max, uint8_t stop1, uint8_t stop2, int stop_ctrl, ssize_t max, ssize_t* restrict amt_out)
+{
+  char* buf_in = *buf;
+  size_t len_in = *buf_len;
+  size_t max_in = *buf_max;
+  char* newbuf;
+  size_t newsz;
+  size_t need;
+  size_t avail;
+  size_t n;
+
+  *amt_out = 0;
+
+  if( ! qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) return 0;
+
+  avail = qio_ptr_diff(ch->cached_end, ch->cached_cur);
+  if( max >= 0 && avail > (size_t) max ) avail = max;
+
+  n = qio_scan_plain_ascii((const uint8_t*) ch->cached_cur, avail,
+                           stop1, stop2, stop_ctrl);
+  if( n == 0 ) return 0;
+
+  need = len_in + n + 1;
+  if( need < len_in || need > (SSIZE_MAX-1) ) {
+    // Too big.
+    QIO_RETURN_CONSTANT_ERROR(EOVERFLOW, "");
+  }
+  if( need >= max_in ) {
+    newsz = 2 * max_in;
+    if( newsz < 16  ) newsz = 16;
+    if( newsz < need  ) newsz = need;
+    newbuf = qio_realloc(buf_in, newsz);
+    if( ! newbuf ) return QIO_ENOMEM;
+    buf_in = newbuf;
+    max_in = newsz;
+  }
+
+  qio_memcpy(&buf_in[len_in], ch->cached_cur, n);
+  ch->cached_cur = qio_ptr_add(ch->cached_cur, n);
+  len_in += n;
+
+  *buf = buf_in;
+  *buf_len = len_in;
+  *buf_max = max_in;
+  *amt_out = n;
+
+  return 0;
+}
+
 // string binary style:
 // QIO_BINARY_STRING_STYLE_LEN1B_DATA -1 -- 1 byte of length before
 // QIO_BINARY_STRING_STYLE_LEN2B_DATA -2 -- 2 bytes of length before
@@ -524,6 +594,10 @@ qioerr qio_channel_scan_string(const int threadsafe, qio_channel_t* restrict ch,
   int64_t end_offset;
   ssize_t maxlen_chars = SSIZE_MAX - 1;
   int found_term = 0;
+  int plain_ok;
+  uint8_t plain_stop1;
+  uint8_t plain_stop2;
+  ssize_t plain_amt;
 
   if( maxlen_bytes <= 0 ) maxlen_bytes = SSIZE_MAX - 1;
 
@@ -592,6 +666,15 @@ qioerr qio_channel_scan_string(const int threadsafe, qio_channel_t* restrict ch,
     stop_space = 0;
   }
 
+  // Runs of ASCII bytes other than \ and the terminator can be copied
+  // straight out of the buffer when the locale decodes them as one
+  // character per byte.
+  plain_ok = qio_glocale_utf8 > 0;
+  plain_stop1 = handle_back ? '\\' : QIO_SCAN_NO_STOP;
+  plain_stop2 = QIO_SCAN_NO_STOP;
+  if( !stop_space && 0 <= term_chr && term_chr < 0x80 )
+    plain_stop2 = term_chr;
+
   err = 0;
   for( nread = 0;
       // limit # characters
@@ -601,6 +684,22 @@ qioerr qio_channel_scan_string(const int threadsafe, qio_channel_t* restrict ch,
       // limit # bytes
       qio_channel_offset_unlocked(ch) - mark_offset < maxlen_bytes;
       nread++ ) {
+    if( nread > 0 && plain_ok ) {
+      ssize_t max_chars = maxlen_chars - nread;
+      ssize_t max_bytes = maxlen_bytes -
+                          (qio_channel_offset_unlocked(ch) - mark_offset);
+      err = _append_plain_run(ch, &ret, &ret_len, &ret_max,
+                              plain_stop1, plain_stop2, stop_space,
+                              max_chars < max_bytes ? max_chars : max_bytes,
+                              &plain_amt);
+      if( err ) break;
+      if( plain_amt > 0 ) {
+        // the loop increment counts the last of these characters
+        nread += plain_amt - 1;
+        continue;
+      }
+    }
+
     err = qio_channel_read_char(false, ch, &chr);
     if( err ) break;
 
@@ -2658,6 +2757,210 @@ error:
 }
 
 
+// Exactly representable powers of ten.
+static const double _qio_pow10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline
+int _qio_is_ascii_space(uint8_t b)
+{
+  return b == ' ' || ('\t' <= b && b <= '\r');
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define QIO_SWAR_DIGITS 1
+
+// Are the 8 bytes in v (loaded from memory) all ASCII digits?
+static inline
+int _qio_swar_is_8digits(uint64_t v)
+{
+  return ((v & 0xF0F0F0F0F0F0F0F0ULL) |
+          (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+// Converts 8 ASCII digits (loaded from memory) to their value.
+static inline
+uint32_t _qio_swar_parse_8digits(uint64_t v)
+{
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 100 + (1000000ULL << 32);
+  const uint64_t mul2 = 1 + (10000ULL << 32);
+  v -= 0x3030303030303030ULL;
+  v = (v * 10) + (v >> 8);
+  v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+  return (uint32_t) v;
+}
+#endif
+
+// Reads decimal digits starting at p, stopping at end or at the first
+// non-digit, and adds them to *val.  Returns the position after the
+// digits.  Stores the number of digits read in *ndigits.  *val is only
+// meaningful if leading zeros plus *ndigits is at most 19.
+static inline
+const uint8_t* _qio_scan_digits(const uint8_t* p, const uint8_t* end,
+                                uint64_t* val, int* ndigits)
+{
+  const uint8_t* start = p;
+  uint64_t v = *val;
+#ifdef QIO_SWAR_DIGITS
+  while( end - p >= 8 ) {
+    uint64_t chunk;
+    memcpy(&chunk, p, 8);
+    if( ! _qio_swar_is_8digits(chunk) ) break;
+    v = v * 100000000 + _qio_swar_parse_8digits(chunk);
+    p += 8;
+  }
+#endif
+  while( p < end && (uint8_t)(*p - '0') < 10 ) {
+    v = v * 10 + (*p - '0');
+    p++;
+  }
+  *val = v;
+  *ndigits = p - start;
+  return p;
+}
+
+// Can a number that stopped at p be taken without consulting the
+// general path?  p must be inside the buffered data (or else the
+// number might continue), and must not be a letter or '.' which the
+// general path might interpret as part of the number (e.g. 0x or inf).
+static inline
+int _qio_number_ends_cleanly(const uint8_t* p, const uint8_t* end)
+{
+  uint8_t b;
+  if( p >= end ) return 0;
+  b = *p;
+  if( b == '.' || b == '_' ) return 0;
+  if( '0' <= b && b <= '9' ) return 0;
+  b |= 0x20;
+  if( 'a' <= b && b <= 'z' ) return 0;
+  return 1;
+}
+
+// Skips ASCII whitespace and reads an optional sign.
+static inline
+const uint8_t* _qio_scan_sign(const uint8_t* p, const uint8_t* end,
+                              int allow_neg, int* sign)
+{
+  while( p < end && _qio_is_ascii_space(*p) ) p++;
+  *sign = 1;
+  if( p < end ) {
+    if( *p == '+' ) p++;
+    else if( allow_neg && *p == '-' ) {
+      *sign = -1;
+      p++;
+    }
+  }
+  return p;
+}
+
+// Parses a plain decimal integer at the start of [p, end).  Returns the
+// number of bytes used, or 0 if the general path is needed.
+static
+ssize_t _qio_parse_int_fast(const uint8_t* start, const uint8_t* end,
+                            int issigned, uint64_t* num_out, int* sign_out)
+{
+  const uint8_t* p;
+  uint64_t num = 0;
+  int ndigits;
+  int sign;
+
+  p = _qio_scan_sign(start, end, issigned, &sign);
+  p = _qio_scan_digits(p, end, &num, &ndigits);
+  if( ndigits == 0 || ndigits > 19 ) return 0;
+  if( ! _qio_number_ends_cleanly(p, end) ) return 0;
+
+  *num_out = num;
+  *sign_out = sign;
+  return p - start;
+}
+
+// Parses a plain decimal floating point number, e.g. -12.5e-3, at the
+// start of [p, end).  It handles the numbers for which an exactly
+// rounded result can be computed with one double multiply or divide
+// (those with at most 19 significant digits whose value times a power
+// of ten at most 22 fits in 53 bits).  Returns the number of bytes used,
+// or 0 if the general path is needed.
+static
+ssize_t _qio_parse_float_fast(const uint8_t* start, const uint8_t* end,
+                              double* out)
+{
+  const uint8_t* p;
+  const uint8_t* digits;
+  uint64_t mant = 0;
+  uint64_t expv = 0;
+  int64_t exp10 = 0;
+  int nint, nfrac = 0, nexp;
+  int lead = 0;
+  int sign, expsign;
+  double d;
+
+// The fast path needs double arithmetic to be done in double precision.
+// 16 only means _Float16 is evaluated as float (GCC with -march=native).
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0 && FLT_EVAL_METHOD != 16
+  return 0;
+#endif
+
+  p = _qio_scan_sign(start, end, 1, &sign);
+
+  // Leading zeros don't count against the 19 digits.
+  digits = p;
+  while( p < end && *p == '0' ) p++;
+  lead = p - digits;
+  p = _qio_scan_digits(p, end, &mant, &nint);
+  if( p < end && *p == '.' ) {
+    p++;
+    if( mant == 0 ) {
+      const uint8_t* z = p;
+      while( p < end && *p == '0' ) p++;
+      lead += p - z;
+      exp10 -= p - z;
+    }
+    p = _qio_scan_digits(p, end, &mant, &nfrac);
+    exp10 -= nfrac;
+  }
+  if( nint + nfrac + lead == 0 ) return 0;
+  if( nint + nfrac > 19 ) return 0;
+
+  if( p < end && (*p | 0x20) == 'e' ) {
+    p++;
+    expsign = 1;
+    if( p < end && (*p == '+' || *p == '-') ) {
+      if( *p == '-' ) expsign = -1;
+      p++;
+    }
+    p = _qio_scan_digits(p, end, &expv, &nexp);
+    if( nexp == 0 || nexp > 4 ) return 0;
+    exp10 += expsign * (int64_t) expv;
+  }
+  if( ! _qio_number_ends_cleanly(p, end) ) return 0;
+
+  if( mant == 0 ) {
+    d = 0.0;
+  } else {
+    if( mant > (1ULL << 53) ) return 0;
+    if( exp10 > 22 ) {
+      // e.g. 12e30 is 12e8 * 1e22; fold what we can into the mantissa.
+      while( exp10 > 22 && mant <= (1ULL << 53) / 10 ) {
+        mant *= 10;
+        exp10--;
+      }
+      if( exp10 > 22 ) return 0;
+    }
+    if( exp10 < -22 ) return 0;
+    d = (double) mant;
+    if( exp10 < 0 ) d /= _qio_pow10[-exp10];
+    else d *= _qio_pow10[exp10];
+  }
+
+  *out = (sign < 0) ? -d : d;
+  return p - start;
+}
+
+
 qioerr qio_channel_scan_int(const int threadsafe, qio_channel_t* restrict ch, void* restrict out, size_t len, int issigned)
 {
   unsigned long long int num = 0;
@@ -2683,6 +2986,22 @@ qioerr qio_channel_scan_int(const int threadsafe, qio_channel_t* restrict ch, vo
 
   style = &ch->style;
 
+  // Plain decimal integers can be read straight out of the buffer.
+  if( (style->base == 0 || style->base == 10) &&
+      !(style->showpoint || style->precision > 0) &&
+      style->positive_char == '+' && style->negative_char == '-' &&
+      qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) {
+    uint64_t fast_num;
+    ssize_t used = _qio_parse_int_fast(ch->cached_cur, ch->cached_end,
+                                       issigned, &fast_num, &sign);
+    if( used > 0 ) {
+      num = fast_num;
+      ch->cached_cur = qio_ptr_add(ch->cached_cur, used);
+      err = 0;
+      goto error;
+    }
+  }
+
   memset(&st, 0, sizeof(number_reading_state_t));
 
   st.base = style->base;
@@ -2843,6 +3162,21 @@ qioerr qio_channel_scan_float_or_imag(const int threadsafe, qio_channel_t* restr
 
   needs_i = imag && style->complex_style == QIO_COMPLEX_FORMAT_ABI;
 
+  // Plain decimal numbers can be read straight out of the buffer.
+  if( !needs_i &&
+      (style->base == 0 || style->base == 10) &&
+      style->point_char == '.' && tolower(style->exponent_char) == 'e' &&
+      style->positive_char == '+' && style->negative_char == '-' &&
+      qio_space_in_ptr_diff(1, ch->cached_end, ch->cached_cur) ) {
+    ssize_t used = _qio_parse_float_fast(ch->cached_cur, ch->cached_end,
+                                         &num);
+    if( used > 0 ) {
+      ch->cached_cur = qio_ptr_add(ch->cached_cur, used);
+      err = 0;
+      goto error;
+    }
+  }
+
   memset(&st, 0, sizeof(number_reading_state_t));
 
   st.base = style->base;
@@ -3003,12 +3337,42 @@ qioerr qio_channel_scan_imag(const int threadsafe, qio_channel_t* restrict ch, v
 // Returns the number of positions in tmp to skip to get to number.
 // Returns -1 on buffer overflow.
 // supports up to base 36.
+static const char _qio_digit_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
 static inline int _ltoa_convert(char *tmp, int tmplen, uint64_t num, int base, int uppercase)
 {
   int at;
   int digit;
   char ch;
   tmp[tmplen-1] = '\0';
+  if( base == 10 && tmplen > 20 ) {
+    // Decimal: two digits per division.
+    at = tmplen-1;
+    while( num >= 100 ) {
+      digit = 2 * (num % 100);
+      num /= 100;
+      tmp[--at] = _qio_digit_pairs[digit + 1];
+      tmp[--at] = _qio_digit_pairs[digit];
+    }
+    if( num >= 10 ) {
+      digit = 2 * num;
+      tmp[--at] = _qio_digit_pairs[digit + 1];
+      tmp[--at] = _qio_digit_pairs[digit];
+    } else {
+      tmp[--at] = '0' + num;
+    }
+    return at;
+  }
   for( at = tmplen-2; at >= 0; at-- ) {
     // Get the remainder mod base
     digit = num % base;
@@ -3164,6 +3528,94 @@ static int _find_prec(char *buf, int len){
   return last_dig;
 }
 
+// Formats a positive finite num the way _ftoa_core's default lowercase
+// realfmt (%g with its 6 significant digits, except that numbers in
+// [100000, 1000000) use %e) would, into buf, with snprintf's return
+// value and truncation conventions.  Returns -1 when the digits can't
+// be found quickly and exactly, in which case the caller uses snprintf.
+static
+int _qio_ftoa_default_fast(char* buf, size_t buf_sz, double num)
+{
+  char tmp[32];
+  char ds[6];
+  int got = 0;
+  int e, nd, i, bexp, tries;
+  uint32_t d;
+  double scaled, frac;
+
+  if( num == 0.0 ) {
+    tmp[got++] = '0';
+  } else {
+    if( !(num >= 1e-17 && num < 1e22) ) return -1;
+
+    // Find e so that num = d * 10^(e-5) with 100000 <= d < 1000000.
+    frexp(num, &bexp);
+    e = ((bexp - 1) * 1233) >> 12; // about (bexp - 1) * log10(2)
+    for( tries = 0; ; tries++ ) {
+      if( tries > 2 || e < -17 || e > 27 ) return -1;
+      if( e <= 5 ) scaled = num * _qio_pow10[5 - e];
+      else scaled = num / _qio_pow10[e - 5];
+      if( scaled >= 1000000.0 ) e++;
+      else if( scaled < 100000.0 ) e--;
+      else break;
+    }
+
+    // scaled is within about 1e-10 of the exact value, which can only
+    // matter when it is close to halfway between two integers.
+    frac = scaled - floor(scaled);
+    if( frac > 0.5 - 1e-6 && frac < 0.5 + 1e-6 ) return -1;
+    d = (uint32_t) (scaled + 0.5);
+    if( d == 1000000 ) {
+      d = 100000;
+      e++;
+    }
+
+    for( i = 5; i >= 0; i-- ) {
+      ds[i] = '0' + d % 10;
+      d /= 10;
+    }
+    nd = 6;
+    while( nd > 1 && ds[nd-1] == '0' ) nd--;
+
+    if( !(num >= 100000.0 && num < 1000000.0) && -4 <= e && e < 6 ) {
+      // %f style
+      if( e >= 0 ) {
+        for( i = 0; i <= e; i++ ) tmp[got++] = ds[i];
+        if( nd > e + 1 ) {
+          tmp[got++] = '.';
+          for( ; i < nd; i++ ) tmp[got++] = ds[i];
+        }
+      } else {
+        tmp[got++] = '0';
+        tmp[got++] = '.';
+        for( i = -1; i > e; i-- ) tmp[got++] = '0';
+        for( i = 0; i < nd; i++ ) tmp[got++] = ds[i];
+      }
+    } else {
+      // %e style
+      tmp[got++] = ds[0];
+      if( nd > 1 ) {
+        tmp[got++] = '.';
+        for( i = 1; i < nd; i++ ) tmp[got++] = ds[i];
+      }
+      tmp[got++] = 'e';
+      tmp[got++] = e < 0 ? '-' : '+';
+      if( e < 0 ) e = -e;
+      if( e >= 100 ) tmp[got++] = '0' + e / 100;
+      tmp[got++] = '0' + (e / 10) % 10;
+      tmp[got++] = '0' + e % 10;
+    }
+  }
+
+  // Copy out like snprintf would.
+  if( buf_sz > 0 ) {
+    size_t n = ((size_t) got < buf_sz) ? (size_t) got : buf_sz - 1;
+    memcpy(buf, tmp, n);
+    buf[n] = '\0';
+  }
+  return got;
+}
+
 // Converts num to a string in buf, returns the number
 // of bytes that would be used if space permits (not including null)
 // or -1 on error
@@ -3230,7 +3682,14 @@ int _ftoa_core(char* buf, size_t buf_sz, double num,
     if( !isnan(num) && !isinf(num) ) *skip = 2;
   } else if( realfmt == 0 ) {
     if( precision < 0 ) {
-      if( uppercase ) {
+      // Try the fast path first; it gives up on any number it can't
+      // print exactly as below.
+      got = -1;
+      if( ! uppercase ) got = _qio_ftoa_default_fast(buf, buf_sz, num);
+
+      if( got >= 0 ) {
+        // OK!
+      } else if( uppercase ) {
         // This if is necessary because if the number has
         // 6 digits in the integer part, %g will not print
         // the decimal part because the integer part have
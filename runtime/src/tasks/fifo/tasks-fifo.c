@@ -24,7 +24,9 @@
 #include "chplrt.h"
 #include "chpl_rt_utils_static.h"
 #include "chplcgfns.h"
+#include "chpl-atomics.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
@@ -61,6 +63,10 @@ typedef struct task_pool_struct {
   task_pool_p      next;         // double-link pointers for pool
   task_pool_p      prev;
 
+  chpl_bool            ws_on_list; // work stealing: on a task list?
+  atomic_int_least32_t ws_claimed; // work stealing: nonzero once started
+  atomic_int_least32_t ws_refs;    // work stealing: holders of this desc
+
   chpl_task_prvDataImpl_t chpl_data;
 
   chpl_task_bundle_t bundle; // ends in a variable-length array
@@ -76,10 +82,34 @@ typedef struct lockReport {
 } lockReport_t;
 
 
+//
+// Work-stealing deque (Chase and Lev, "Dynamic Circular Work-Stealing
+// Deque", SPAA 2005, with the memory orderings of Le et al., PPoPP
+// 2013).  The owning thread pushes and takes at the bottom; other
+// threads steal from the top.  Arrays that are outgrown are kept on
+// the prev list rather than freed, since a thief may still be reading
+// one.
+//
+typedef struct ws_array_struct {
+  int64_t                  size;       // always a power of 2
+  struct ws_array_struct*  prev;
+  atomic_uintptr_t         slots[];
+} ws_array_t;
+
+typedef struct {
+  atomic_int_least64_t     top;
+  char                     pad[64];    // separate top and bottom lines
+  atomic_int_least64_t     bottom;
+  atomic_uintptr_t         array;
+} ws_deque_t;
+
+
 // This is the data that is private to each thread.
 typedef struct {
   task_pool_p   ptask;
   lockReport_t* lockRprt;
+  ws_deque_t*   deque;         // work stealing: our deque, if any
+  uint64_t      rand_state;    // work stealing: victim selection
 } thread_private_data_t;
 
 
@@ -113,6 +143,39 @@ static chpl_thread_mutex_t taskTable_lock;     // critical section lock
 
 static chpl_fn_p comm_task_fn;
 
+//
+// Work stealing.  When CHPL_RT_WORK_STEALING is set, each thread that
+// runs tasks owns a deque.  Tasks created by such a thread go on its
+// own deque, and the thread takes work from there first, then from the
+// shared pool (which still holds tasks created by threads that have no
+// deque, such as the main and comm threads), and finally by stealing
+// from randomly chosen other threads.  Threads that find nothing to do
+// park on a condition variable until more work is created.
+//
+#define WS_DEQUE_INIT_SIZE  64
+#define WS_MAX_DEQUES_DFLT  1024
+#define WS_STEAL_SPINS      64
+#define WS_PARK_USECS       10000
+
+static chpl_bool           work_stealing = false;
+static atomic_uintptr_t*   ws_deques;          // deques of all threads
+static int                 ws_max_deques;
+static atomic_int_least32_t
+                           ws_num_deques;
+static atomic_int_least32_t
+                           ws_queued_cnt;      // queued_task_cnt, for ws
+static atomic_int_least32_t
+                           ws_idle_cnt;        // idle_thread_cnt, for ws
+static chpl_thread_mutex_t ws_park_lock;       // protects ws_park_cond
+static chpl_thread_condvar_t
+                           ws_park_cond;
+static atomic_int_least32_t
+                           ws_spinning_cnt;    // threads looking for work
+static atomic_int_least32_t
+                           ws_parked_cnt;      // threads waiting for work
+static atomic_int_least32_t
+                           ws_wake_pending;    // signaled, not yet woken
+
 //
 // Internal functions.
 //
@@ -134,6 +197,7 @@ static void                    initializeLockReportForThread(void);
 static chpl_bool               set_block_loc(int, int32_t);
 static void                    unset_block_loc(void);
 static void                    check_for_deadlock(void);
+static task_pool_p             pool_wait_for_task(void);
 static void                    thread_begin(void*);
 static void                    thread_end(void);
 static void                    maybe_add_thread(void);
@@ -141,6 +205,27 @@ static task_pool_p             add_to_task_pool(chpl_fn_int_t, chpl_fn_p,
                                                 chpl_task_bundle_t*, size_t,
                                                 chpl_bool, task_pool_p*,
                                                 chpl_bool, int, int32_t);
+static void                    run_task_inline(task_pool_p, task_pool_p);
+static void                    ws_init(void);
+static ws_array_t*             ws_array_create(int64_t, ws_array_t*);
+static ws_deque_t*             ws_deque_create(void);
+static int32_t                 ws_get_num_deques(void);
+static ws_deque_t*             ws_get_deque(int32_t);
+static void                    ws_push(ws_deque_t*, task_pool_p);
+static task_pool_p             ws_take(ws_deque_t*);
+static chpl_bool               ws_peek(ws_deque_t*);
+static task_pool_p             ws_steal(ws_deque_t*);
+static void                    ws_wake_one(void);
+static void                    ws_enqueue_task(task_pool_p, task_pool_p*);
+static chpl_bool               ws_claim_task(task_pool_p);
+static void                    ws_release_task(task_pool_p);
+static task_pool_p             ws_take_any(thread_private_data_t*);
+static task_pool_p             ws_find_task(thread_private_data_t*);
+static chpl_bool               ws_work_available(void);
+static void                    ws_park(struct timeval*);
+static task_pool_p             ws_wait_for_task(thread_private_data_t*);
+static void                    ws_execute_tasks_in_list(task_pool_p*);
+static void                    ws_report_pending_tasks(void);
 
 //
 // Condition variable methods
@@ -341,6 +426,10 @@ void chpl_task_init(void) {
 
   chpl_thread_init(thread_begin, thread_end);
 
+  work_stealing = chpl_env_rt_get_bool("WORK_STEALING", false);
+  if (work_stealing)
+    ws_init();
+
   //
   // Set main thread private data, so that things that require access
   // to it, like chpl_task_getID() and chpl_task_setSerial(), can be
@@ -595,8 +684,9 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
                              int32_t filename) {
   assert(subloc == c_sublocid_any);
 
-  // begin critical section
-  chpl_thread_mutexLock(&threading_lock);
+  // begin critical section (work stealing does its own locking)
+  if (!work_stealing)
+    chpl_thread_mutexLock(&threading_lock);
 
   if (task_list_locale == chpl_nodeID) {
     (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
@@ -616,7 +706,8 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
   }
 
   // end critical section
-  chpl_thread_mutexUnlock(&threading_lock);
+  if (!work_stealing)
+    chpl_thread_mutexUnlock(&threading_lock);
 }
 
 
@@ -628,6 +719,11 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
   // Note: this function needs to tolerate an empty task
   // list. That will happen for coforalls inside a serial block, say.
 
+  if (work_stealing) {
+    ws_execute_tasks_in_list(p_task_list_head);
+    return;
+  }
+
   curr_ptask = get_current_ptask();
 
   while (*p_task_list_head != NULL) {
@@ -647,61 +743,69 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
     if (task_to_run_fun == NULL)
       continue;
 
-    set_current_ptask(child_ptask);
+    run_task_inline(curr_ptask, child_ptask);
+    chpl_mem_free(child_ptask, 0, 0);
+  }
+}
 
-    // begin critical section
-    chpl_thread_mutexLock(&extra_task_lock);
 
-    extra_task_cnt++;
+//
+// Run a task that has been taken out of the pool on behalf of the
+// task now running on this thread, which is waiting for it.
+//
+static void run_task_inline(task_pool_p curr_ptask, task_pool_p child_ptask) {
+  set_current_ptask(child_ptask);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&extra_task_lock);
+  // begin critical section
+  chpl_thread_mutexLock(&extra_task_lock);
 
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_suspended(curr_ptask->bundle.id);
-      chpldev_taskTable_set_active(child_ptask->bundle.id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
+  extra_task_cnt++;
 
-    if (blockreport)
-      initializeLockReportForThread();
+  // end critical section
+  chpl_thread_mutexUnlock(&extra_task_lock);
 
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
-                           child_ptask->bundle.requested_fid,
-                           child_ptask->bundle.filename,
-                           child_ptask->bundle.lineno,
-                           child_ptask->bundle.id,
-                           child_ptask->bundle.is_executeOn);
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_suspended(curr_ptask->bundle.id);
+    chpldev_taskTable_set_active(child_ptask->bundle.id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
 
-    (*task_to_run_fun)(&child_ptask->bundle);
+  if (blockreport)
+    initializeLockReportForThread();
 
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
-                           child_ptask->bundle.requested_fid,
-                           child_ptask->bundle.filename,
-                           child_ptask->bundle.lineno,
-                           child_ptask->bundle.id,
-                           child_ptask->bundle.is_executeOn);
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
+                         child_ptask->bundle.requested_fid,
+                         child_ptask->bundle.filename,
+                         child_ptask->bundle.lineno,
+                         child_ptask->bundle.id,
+                         child_ptask->bundle.is_executeOn);
 
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_active(curr_ptask->bundle.id);
-      chpldev_taskTable_remove(child_ptask->bundle.id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
+  (child_ptask->bundle.requested_fn)(&child_ptask->bundle);
 
-    // begin critical section
-    chpl_thread_mutexLock(&extra_task_lock);
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
+                         child_ptask->bundle.requested_fid,
+                         child_ptask->bundle.filename,
+                         child_ptask->bundle.lineno,
+                         child_ptask->bundle.id,
+                         child_ptask->bundle.is_executeOn);
 
-    extra_task_cnt--;
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_active(curr_ptask->bundle.id);
+    chpldev_taskTable_remove(child_ptask->bundle.id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
 
-    // end critical section
-    chpl_thread_mutexUnlock(&extra_task_lock);
+  // begin critical section
+  chpl_thread_mutexLock(&extra_task_lock);
 
-    set_current_ptask(curr_ptask);
-    chpl_mem_free(child_ptask, 0, 0);
+  extra_task_cnt--;
 
-  }
+  // end critical section
+  chpl_thread_mutexUnlock(&extra_task_lock);
+
+  set_current_ptask(curr_ptask);
 }
 
 
@@ -718,14 +822,16 @@ void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
                   chpl_task_bundle_t* arg, size_t arg_size,
                   c_sublocid_t subloc,
                   int lineno, int32_t filename) {
-  // begin critical section
-  chpl_thread_mutexLock(&threading_lock);
+  // begin critical section (work stealing does its own locking)
+  if (!work_stealing)
+    chpl_thread_mutexLock(&threading_lock);
 
   (void) add_to_task_pool(fid, fp, arg, arg_size, true,
                           NULL, false, lineno, filename);
 
   // end critical section
-  chpl_thread_mutexUnlock(&threading_lock);
+  if (!work_stealing)
+    chpl_thread_mutexUnlock(&threading_lock);
 }
 
 
@@ -847,6 +953,8 @@ chpl_bool chpl_task_guardPagesInUse(void) {
 }
 
 uint32_t chpl_task_getNumQueuedTasks(void) {
+  if (work_stealing)
+    return atomic_load_int_least32_t(&ws_queued_cnt);
   return queued_task_cnt;
 }
 
@@ -858,7 +966,7 @@ int32_t chpl_task_getNumBlockedTasks(void) {
     chpl_thread_mutexLock(&threading_lock);
     chpl_thread_mutexLock(&block_report_lock);
 
-    numBlockedTasks = blocked_thread_cnt - idle_thread_cnt;
+    numBlockedTasks = blocked_thread_cnt - chpl_task_getNumIdleThreads();
 
     // end critical section
     chpl_thread_mutexUnlock(&block_report_lock);
@@ -964,6 +1072,8 @@ static void report_all_tasks(void) {
            pendingTask->bundle.lineno);
     pendingTask = pendingTask->next;
   }
+  if (work_stealing)
+    ws_report_pending_tasks();
   printf("\n");
 
   // print out running tasks
@@ -1110,23 +1220,10 @@ static void check_for_deadlock(void) {
 
 
 //
-// When we create a thread it runs this wrapper function, which just
-// executes tasks out of the pool as they become available.
+// Wait for a task to be present in the task pool, and take it.
 //
-static void
-thread_begin(void* ptask_void) {
+static task_pool_p pool_wait_for_task(void) {
   task_pool_p ptask;
-  thread_private_data_t *tp;
-
-  tp = (thread_private_data_t*) chpl_mem_alloc(sizeof(thread_private_data_t),
-                                               CHPL_RT_MD_THREAD_PRV_DATA,
-                                               0, 0);
-  chpl_thread_setPrivateData(tp);
-
-  tp->ptask = NULL;
-  tp->lockRprt = NULL;
-  if (blockreport)
-    initializeLockReportForThread();
 
   while (true) {
     //
@@ -1200,6 +1297,36 @@ thread_begin(void* ptask_void) {
     // end critical section
     chpl_thread_mutexUnlock(&threading_lock);
 
+    return ptask;
+  }
+}
+
+
+//
+// When we create a thread it runs this wrapper function, which just
+// executes tasks out of the pool as they become available.
+//
+static void
+thread_begin(void* ptask_void) {
+  task_pool_p ptask;
+  thread_private_data_t *tp;
+
+  tp = (thread_private_data_t*) chpl_mem_alloc(sizeof(thread_private_data_t),
+                                               CHPL_RT_MD_THREAD_PRV_DATA,
+                                               0, 0);
+  chpl_thread_setPrivateData(tp);
+
+  tp->ptask = NULL;
+  tp->lockRprt = NULL;
+  if (blockreport)
+    initializeLockReportForThread();
+
+  tp->deque = work_stealing ? ws_deque_create() : NULL;
+  tp->rand_state = (uint64_t) (intptr_t) tp;
+
+  while (true) {
+    ptask = work_stealing ? ws_wait_for_task(tp) : pool_wait_for_task();
+
     tp->ptask = ptask;
 
     if (do_taskReport) {
@@ -1231,6 +1358,13 @@ thread_begin(void* ptask_void) {
     }
 
     tp->ptask = NULL;
+
+    if (work_stealing) {
+      ws_release_task(ptask);
+      atomic_fetch_add_int_least32_t(&ws_idle_cnt, 1);
+      continue;
+    }
+
     chpl_mem_free(ptask, 0, 0);
 
     // begin critical section
@@ -1274,7 +1408,10 @@ static void maybe_add_thread(void) {
 
   if (!warning_issued && chpl_thread_canCreate()) {
     if (chpl_thread_create(NULL) == 0) {
-      idle_thread_cnt++;
+      if (work_stealing)
+        atomic_fetch_add_int_least32_t(&ws_idle_cnt, 1);
+      else
+        idle_thread_cnt++;
     }
     else {
       int32_t max_threads = chpl_thread_getMaxThreads();
@@ -1298,8 +1435,9 @@ static void maybe_add_thread(void) {
 
 
 // create a task from the given function pointer and arguments
-// and append it to the end of the task pool
-// assumes threading_lock has already been acquired!
+// and append it to the end of the task pool (or with work stealing,
+// push it onto this thread's deque)
+// assumes threading_lock has already been acquired, unless work stealing!
 static inline
 task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
                              chpl_task_bundle_t* a, size_t a_size,
@@ -1338,6 +1476,34 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   ptask->bundle.requested_fn    = fp;
   ptask->bundle.id              = get_next_task_id();
 
+  if (work_stealing) {
+    ptask->ws_on_list = (p_task_list_head != NULL);
+    atomic_init_int_least32_t(&ptask->ws_claimed, 0);
+    atomic_init_int_least32_t(&ptask->ws_refs, ptask->ws_on_list ? 2 : 1);
+
+    //
+    // There is no lock held here, and once the task is queued another
+    // thread may start it, so announce it first.
+    //
+    chpl_task_do_callbacks(chpl_task_cb_event_kind_create,
+                           ptask->bundle.requested_fid,
+                           ptask->bundle.filename,
+                           ptask->bundle.lineno,
+                           ptask->bundle.id,
+                           ptask->bundle.is_executeOn);
+
+    if (do_taskReport) {
+      chpl_thread_mutexLock(&taskTable_lock);
+      chpldev_taskTable_add(ptask->bundle.id,
+                            ptask->bundle.lineno, ptask->bundle.filename,
+                            (uint64_t) (intptr_t) ptask);
+      chpl_thread_mutexUnlock(&taskTable_lock);
+    }
+
+    ws_enqueue_task(ptask, p_task_list_head);
+    return ptask;
+  }
+
   enqueue_task(ptask, p_task_list_head);
 
   chpl_task_do_callbacks(chpl_task_cb_event_kind_create,
@@ -1365,6 +1531,571 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
 }
 
 
+// Work stealing
+
+static void ws_init(void) {
+  int32_t max_threads = chpl_thread_getMaxThreads();
+  int i;
+
+  //
+  // Threads beyond the first ws_max_deques run without a deque of their
+  // own.  They put the tasks they create in the shared pool, but can
+  // still steal.
+  //
+  ws_max_deques = (max_threads > 0) ? max_threads : WS_MAX_DEQUES_DFLT;
+  ws_deques = (atomic_uintptr_t*)
+              chpl_mem_allocMany(ws_max_deques, sizeof(atomic_uintptr_t),
+                                 CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  for (i = 0; i < ws_max_deques; i++)
+    atomic_init_uintptr_t(&ws_deques[i], (uintptr_t) NULL);
+  atomic_init_int_least32_t(&ws_num_deques, 0);
+  atomic_init_int_least32_t(&ws_queued_cnt, 0);
+  atomic_init_int_least32_t(&ws_idle_cnt, 0);
+
+  chpl_thread_mutexInit(&ws_park_lock);
+  chpl_thread_condvar_init(&ws_park_cond);
+  atomic_init_int_least32_t(&ws_spinning_cnt, 0);
+  atomic_init_int_least32_t(&ws_parked_cnt, 0);
+  atomic_init_int_least32_t(&ws_wake_pending, 0);
+}
+
+
+static ws_array_t* ws_array_create(int64_t size, ws_array_t* prev) {
+  ws_array_t* a;
+  int64_t i;
+
+  a = (ws_array_t*) chpl_mem_alloc(sizeof(ws_array_t)
+                                   + size * sizeof(atomic_uintptr_t),
+                                   CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  a->size = size;
+  a->prev = prev;
+  for (i = 0; i < size; i++)
+    atomic_init_uintptr_t(&a->slots[i], (uintptr_t) NULL);
+
+  return a;
+}
+
+
+//
+// Create a deque for the calling thread and make it visible to
+// thieves.  Returns NULL if there is no room left in the registry.
+//
+static ws_deque_t* ws_deque_create(void) {
+  ws_deque_t* dq;
+  int32_t idx;
+
+  idx = atomic_fetch_add_int_least32_t(&ws_num_deques, 1);
+  if (idx >= ws_max_deques)
+    return NULL;
+
+  dq = (ws_deque_t*) chpl_mem_alloc(sizeof(ws_deque_t),
+                                    CHPL_RT_MD_TASK_LAYER_UNSPEC, 0, 0);
+  atomic_init_int_least64_t(&dq->top, 0);
+  atomic_init_int_least64_t(&dq->bottom, 0);
+  atomic_init_uintptr_t(&dq->array,
+                        (uintptr_t) ws_array_create(WS_DEQUE_INIT_SIZE,
+                                                    NULL));
+
+  atomic_store_explicit_uintptr_t(&ws_deques[idx], (uintptr_t) dq,
+                                  memory_order_release);
+  return dq;
+}
+
+
+static int32_t ws_get_num_deques(void) {
+  int32_t num_deques = atomic_load_int_least32_t(&ws_num_deques);
+
+  return (num_deques < ws_max_deques) ? num_deques : ws_max_deques;
+}
+
+
+static ws_deque_t* ws_get_deque(int32_t idx) {
+  return (ws_deque_t*) atomic_load_explicit_uintptr_t(&ws_deques[idx],
+                                                      memory_order_acquire);
+}
+
+
+//
+// Push a task on the bottom of a deque.  Only the owner may do this.
+//
+static void ws_push(ws_deque_t* dq, task_pool_p ptask) {
+  int64_t b = atomic_load_explicit_int_least64_t(&dq->bottom,
+                                                 memory_order_relaxed);
+  int64_t t = atomic_load_explicit_int_least64_t(&dq->top,
+                                                 memory_order_acquire);
+  ws_array_t* a = (ws_array_t*)
+                  atomic_load_explicit_uintptr_t(&dq->array,
+                                                 memory_order_relaxed);
+
+  if (b - t > a->size - 1) {
+    ws_array_t* new_a = ws_array_create(2 * a->size, a);
+    int64_t i;
+
+    for (i = t; i < b; i++) {
+      uintptr_t v = atomic_load_explicit_uintptr_t(&a->slots[i & (a->size - 1)],
+                                                   memory_order_relaxed);
+      atomic_store_explicit_uintptr_t(&new_a->slots[i & (new_a->size - 1)],
+                                      v, memory_order_relaxed);
+    }
+    atomic_store_explicit_uintptr_t(&dq->array, (uintptr_t) new_a,
+                                    memory_order_release);
+    a = new_a;
+  }
+
+  atomic_store_explicit_uintptr_t(&a->slots[b & (a->size - 1)],
+                                  (uintptr_t) ptask, memory_order_relaxed);
+  chpl_atomic_thread_fence(memory_order_release);
+  atomic_store_explicit_int_least64_t(&dq->bottom, b + 1,
+                                      memory_order_relaxed);
+}
+
+
+//
+// Take the most recently pushed task from the bottom of a deque.  Only
+// the owner may do this.  Returns NULL if the deque is empty.
+//
+static task_pool_p ws_take(ws_deque_t* dq) {
+  int64_t b = atomic_load_explicit_int_least64_t(&dq->bottom,
+                                                 memory_order_relaxed) - 1;
+  ws_array_t* a = (ws_array_t*)
+                  atomic_load_explicit_uintptr_t(&dq->array,
+                                                 memory_order_relaxed);
+  task_pool_p ptask = NULL;
+  int64_t t;
+
+  atomic_store_explicit_int_least64_t(&dq->bottom, b, memory_order_relaxed);
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  t = atomic_load_explicit_int_least64_t(&dq->top, memory_order_relaxed);
+
+  if (t <= b) {
+    ptask = (task_pool_p)
+            atomic_load_explicit_uintptr_t(&a->slots[b & (a->size - 1)],
+                                           memory_order_relaxed);
+    if (t == b) {
+      // This is the last task; thieves may be racing us for it.
+      if (!atomic_compare_exchange_strong_explicit_int_least64_t(
+                 &dq->top, t, t + 1, memory_order_seq_cst))
+        ptask = NULL;
+      atomic_store_explicit_int_least64_t(&dq->bottom, b + 1,
+                                          memory_order_relaxed);
+    }
+  }
+  else {
+    atomic_store_explicit_int_least64_t(&dq->bottom, b + 1,
+                                        memory_order_relaxed);
+  }
+
+  return ptask;
+}
+
+
+//
+// Cheaply check whether a deque might have anything in it.
+//
+static chpl_bool ws_peek(ws_deque_t* dq) {
+  return (atomic_load_explicit_int_least64_t(&dq->bottom,
+                                             memory_order_relaxed)
+          > atomic_load_explicit_int_least64_t(&dq->top,
+                                               memory_order_relaxed));
+}
+
+
+//
+// Steal the oldest task from the top of another thread's deque.
+// Returns NULL if the deque is empty or we lost a race for the task.
+//
+static task_pool_p ws_steal(ws_deque_t* dq) {
+  int64_t t = atomic_load_explicit_int_least64_t(&dq->top,
+                                                 memory_order_acquire);
+  int64_t b;
+
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  b = atomic_load_explicit_int_least64_t(&dq->bottom, memory_order_acquire);
+
+  if (t < b) {
+    ws_array_t* a = (ws_array_t*)
+                    atomic_load_explicit_uintptr_t(&dq->array,
+                                                   memory_order_acquire);
+    task_pool_p ptask = (task_pool_p)
+                        atomic_load_explicit_uintptr_t(
+                          &a->slots[t & (a->size - 1)],
+                          memory_order_relaxed);
+
+    if (atomic_compare_exchange_strong_explicit_int_least64_t(
+              &dq->top, t, t + 1, memory_order_seq_cst))
+      return ptask;
+  }
+
+  return NULL;
+}
+
+
+//
+// Wake a parked thread, unless some thread is already looking for work
+// or is about to wake up and do so.  In that case it will find what
+// there is, and wake another if it leaves work behind.
+//
+static void ws_wake_one(void) {
+  if (atomic_load_int_least32_t(&ws_spinning_cnt) == 0
+      && atomic_load_int_least32_t(&ws_wake_pending) == 0
+      && atomic_load_int_least32_t(&ws_parked_cnt) > 0
+      && atomic_exchange_int_least32_t(&ws_wake_pending, 1) == 0) {
+    chpl_thread_mutexLock(&ws_park_lock);
+    (void) pthread_cond_signal(&ws_park_cond);
+    chpl_thread_mutexUnlock(&ws_park_lock);
+  }
+}
+
+
+//
+// Queue a task for execution.  A thread with a deque pushes the task
+// there; other threads use the shared pool.
+//
+static void ws_enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
+  thread_private_data_t* tp;
+
+  //
+  // Tasks on a list may be started either by a thread that finds them
+  // in a deque or the pool or by the list's owner in
+  // ws_execute_tasks_in_list().  Whichever claims the task first runs
+  // it, and the descriptor is freed when both have let it go.
+  //
+  if (p_task_list_head != NULL) {
+    // begin critical section
+    chpl_thread_mutexLock(&task_list_lock);
+
+    ptask->list_next = *p_task_list_head;
+    *p_task_list_head = ptask;
+
+    // end critical section
+    chpl_thread_mutexUnlock(&task_list_lock);
+  }
+
+  atomic_fetch_add_int_least32_t(&ws_queued_cnt, 1);
+
+  tp = (thread_private_data_t*) chpl_thread_getPrivateData();
+  if (tp != NULL && tp->deque != NULL) {
+    ws_push(tp->deque, ptask);
+  }
+  else {
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    enqueue_task(ptask, NULL);
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+
+  //
+  // The fence pairs with the one in ws_park(), so that either a thread
+  // on its way to parking sees the new task or we see it parked.
+  //
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  ws_wake_one();
+
+  // If we now have more tasks than threads to run them on, try to start
+  // another thread
+  if (atomic_load_int_least32_t(&ws_queued_cnt)
+      > atomic_load_int_least32_t(&ws_idle_cnt)
+      && chpl_thread_canCreate()) {
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    maybe_add_thread();
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+}
+
+
+//
+// Claim the right to run a queued task.  This fails only if the task
+// was on a list and its owner got to it first.
+//
+static chpl_bool ws_claim_task(task_pool_p ptask) {
+  if (ptask->ws_on_list
+      && !atomic_compare_exchange_strong_int_least32_t(&ptask->ws_claimed,
+                                                       0, 1))
+    return false;
+
+  atomic_fetch_sub_int_least32_t(&ws_queued_cnt, 1);
+  return true;
+}
+
+
+static void ws_release_task(task_pool_p ptask) {
+  if (!ptask->ws_on_list
+      || atomic_fetch_sub_int_least32_t(&ptask->ws_refs, 1) == 1)
+    chpl_mem_free(ptask, 0, 0);
+}
+
+
+//
+// Remove some queued task from wherever we can find one: our own deque
+// first, then the shared pool, then the deques of other threads chosen
+// at random.  The task has not been claimed yet.
+//
+static task_pool_p ws_take_any(thread_private_data_t* tp) {
+  task_pool_p ptask;
+  int32_t num_deques;
+  int32_t start;
+  int32_t i;
+
+  if (tp->deque != NULL && ws_peek(tp->deque)
+      && (ptask = ws_take(tp->deque)) != NULL)
+    return ptask;
+
+  if (task_pool_head != NULL) {
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    if ((ptask = task_pool_head) != NULL)
+      dequeue_task(ptask);
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+
+    if (ptask != NULL)
+      return ptask;
+  }
+
+  //
+  // Visit every other deque once, starting at a random one.  Peeking
+  // first keeps idle threads from paying for a full steal attempt on
+  // deques that are plainly empty.
+  //
+  num_deques = ws_get_num_deques();
+  if (num_deques == 0)
+    return NULL;
+
+  // xorshift64
+  tp->rand_state ^= tp->rand_state << 13;
+  tp->rand_state ^= tp->rand_state >> 7;
+  tp->rand_state ^= tp->rand_state << 17;
+  start = (int32_t) (tp->rand_state % num_deques);
+
+  for (i = 0; i < num_deques; i++) {
+    ws_deque_t* victim = ws_get_deque((start + i) % num_deques);
+
+    if (victim != NULL && victim != tp->deque && ws_peek(victim)
+        && (ptask = ws_steal(victim)) != NULL)
+      return ptask;
+  }
+
+  return NULL;
+}
+
+
+static task_pool_p ws_find_task(thread_private_data_t* tp) {
+  task_pool_p ptask;
+
+  while ((ptask = ws_take_any(tp)) != NULL) {
+    if (ws_claim_task(ptask))
+      return ptask;
+    ws_release_task(ptask);
+  }
+
+  return NULL;
+}
+
+
+static chpl_bool ws_work_available(void) {
+  int32_t num_deques;
+  int32_t i;
+
+  if (task_pool_head != NULL)
+    return true;
+
+  num_deques = ws_get_num_deques();
+  for (i = 0; i < num_deques; i++) {
+    ws_deque_t* dq = ws_get_deque(i);
+
+    if (dq != NULL && ws_peek(dq))
+      return true;
+  }
+
+  return false;
+}
+
+
+//
+// Wait until another thread queues a task, the given deadline (if any)
+// passes, or WS_PARK_USECS go by.  The bounded wait means that a
+// missed wakeup can delay a thread but not strand it.  Callers must
+// still yield now and then, because the threading layer only lets
+// threads be canceled (at exit) inside chpl_thread_yield().
+//
+static void ws_park(struct timeval* deadline) {
+  struct timeval wakeup;
+  struct timespec ts;
+
+  gettimeofday(&wakeup, NULL);
+  wakeup.tv_usec += WS_PARK_USECS;
+  if (wakeup.tv_usec >= 1000000) {
+    wakeup.tv_sec++;
+    wakeup.tv_usec -= 1000000;
+  }
+  if (deadline != NULL
+      && (deadline->tv_sec < wakeup.tv_sec
+          || (deadline->tv_sec == wakeup.tv_sec
+              && deadline->tv_usec < wakeup.tv_usec)))
+    wakeup = *deadline;
+  ts.tv_sec  = wakeup.tv_sec;
+  ts.tv_nsec = wakeup.tv_usec * 1000UL;
+
+  chpl_thread_mutexLock(&ws_park_lock);
+
+  atomic_fetch_add_int_least32_t(&ws_parked_cnt, 1);
+  chpl_atomic_thread_fence(memory_order_seq_cst);
+  if (!ws_work_available())
+    (void) pthread_cond_timedwait(&ws_park_cond,
+                                  (pthread_mutex_t*) &ws_park_lock, &ts);
+  atomic_fetch_sub_int_least32_t(&ws_parked_cnt, 1);
+  atomic_store_int_least32_t(&ws_wake_pending, 0);
+
+  chpl_thread_mutexUnlock(&ws_park_lock);
+}
+
+
+//
+// The work-stealing counterpart of pool_wait_for_task().  Idle threads
+// look for work for a while, yielding in between, and then park.
+//
+static task_pool_p ws_wait_for_task(thread_private_data_t* tp) {
+  task_pool_p ptask;
+
+  while ((ptask = ws_find_task(tp)) == NULL) {
+    if (set_block_loc(0, CHPL_FILE_IDX_IDLE_TASK)) {
+      // all other tasks appear to be blocked
+      struct timeval deadline, now;
+      gettimeofday(&deadline, NULL);
+      deadline.tv_sec += 1;
+      do {
+        chpl_thread_yield();
+        ws_park(&deadline);
+        if ((ptask = ws_find_task(tp)) == NULL)
+          gettimeofday(&now, NULL);
+      } while (ptask == NULL
+               && (now.tv_sec < deadline.tv_sec
+                   || (now.tv_sec == deadline.tv_sec
+                       && now.tv_usec < deadline.tv_usec)));
+      if (ptask == NULL) {
+        check_for_deadlock();
+      }
+    }
+    else {
+      int spins = 0;
+      chpl_bool parked = false;
+      atomic_fetch_add_int_least32_t(&ws_spinning_cnt, 1);
+      do {
+        chpl_thread_yield();
+        if (++spins >= WS_STEAL_SPINS) {
+          atomic_fetch_sub_int_least32_t(&ws_spinning_cnt, 1);
+          ws_park(NULL);
+          atomic_fetch_add_int_least32_t(&ws_spinning_cnt, 1);
+          parked = true;
+        }
+        //
+        // With block reporting, after each park go back around and
+        // block again, in case every other thread has blocked in the
+        // meantime and it is now up to us to look for deadlock.
+        //
+      } while ((ptask = ws_find_task(tp)) == NULL
+               && !(blockreport && parked));
+      atomic_fetch_sub_int_least32_t(&ws_spinning_cnt, 1);
+    }
+
+    unset_block_loc();
+
+    if (ptask != NULL) {
+      if (ws_work_available())
+        ws_wake_one();
+      break;
+    }
+  }
+
+  if (blockreport) {
+    // begin critical section
+    chpl_thread_mutexLock(&threading_lock);
+
+    progress_cnt++;
+
+    // end critical section
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+
+  atomic_fetch_sub_int_least32_t(&ws_idle_cnt, 1);
+
+  return ptask;
+}
+
+
+//
+// The work-stealing counterpart of the loop in
+// chpl_task_executeTasksInList().  Tasks that some other thread has
+// already claimed are simply let go.
+//
+static void ws_execute_tasks_in_list(task_pool_p* p_task_list_head) {
+  task_pool_p curr_ptask;
+  task_pool_p child_ptask;
+  task_pool_p next_ptask;
+
+  curr_ptask = get_current_ptask();
+
+  while (*p_task_list_head != NULL) {
+    // begin critical section
+    chpl_thread_mutexLock(&task_list_lock);
+
+    child_ptask = *p_task_list_head;
+    *p_task_list_head = NULL;
+
+    // end critical section
+    chpl_thread_mutexUnlock(&task_list_lock);
+
+    for ( ; child_ptask != NULL; child_ptask = next_ptask) {
+      next_ptask = child_ptask->list_next;
+      if (ws_claim_task(child_ptask))
+        run_task_inline(curr_ptask, child_ptask);
+      ws_release_task(child_ptask);
+    }
+  }
+}
+
+
+//
+// Print the tasks still waiting in deques, for report_all_tasks().
+// This runs while the program is being stopped, so it does not
+// synchronize with the threads that own the deques.
+//
+static void ws_report_pending_tasks(void) {
+  int32_t num_deques = ws_get_num_deques();
+  int32_t i;
+
+  for (i = 0; i < num_deques; i++) {
+    ws_deque_t* dq = ws_get_deque(i);
+    ws_array_t* a;
+    int64_t t, b;
+
+    if (dq == NULL)
+      continue;
+
+    a = (ws_array_t*) atomic_load_uintptr_t(&dq->array);
+    t = atomic_load_int_least64_t(&dq->top);
+    b = atomic_load_int_least64_t(&dq->bottom);
+    for ( ; t < b; t++) {
+      task_pool_p ptask = (task_pool_p)
+                          atomic_load_uintptr_t(&a->slots[t & (a->size - 1)]);
+      if (ptask != NULL
+          && atomic_load_int_least32_t(&ptask->ws_claimed) == 0)
+        printf("- %s:%d\n", chpl_lookupFilename(ptask->bundle.filename),
+               ptask->bundle.lineno);
+    }
+  }
+}
+
+
 // Threads
 
 uint32_t chpl_task_getNumThreads(void) {
@@ -1372,5 +2103,7 @@ uint32_t chpl_task_getNumThreads(void) {
 }
 
 uint32_t chpl_task_getNumIdleThreads(void) {
+  if (work_stealing)
+    return atomic_load_int_least32_t(&ws_idle_cnt);
   return idle_thread_cnt;
 }
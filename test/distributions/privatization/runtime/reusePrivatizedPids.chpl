@@ -0,0 +1,47 @@
+// Create and destroy privatized objects repeatedly, as a program that
+// builds new distributed arrays every timestep would, and check that
+// their pids are reused instead of growing the table.
+
+use PrivatizationWrappers;
+
+extern proc chpl_privatization_newPid(): int;
+extern proc chpl_privatization_freePid(pid: int);
+extern proc chpl_numPrivatizedClasses(): int;
+extern proc chpl_privatizedClassesCapacity(): int;
+extern proc chpl_numPrivatizedPidsReused(): int;
+
+config const numSteps = 1000,
+             numPerStep = 10;
+
+const liveBefore = chpl_numPrivatizedClasses(),
+      reusedBefore = chpl_numPrivatizedPidsReused();
+
+var maxPid = -1;
+var capacity = 0;
+
+for step in 1..numSteps {
+  var pids: [1..numPerStep] int;
+
+  for pid in pids {
+    pid = chpl_privatization_newPid();
+    insertPrivatized(new unmanaged C(pid), pid);
+    maxPid = max(maxPid, pid);
+  }
+
+  forall pid in pids do
+    assert(getPrivatized(pid).i == pid);
+
+  if step == 1 then
+    capacity = chpl_privatizedClassesCapacity();
+
+  for pid in pids {
+    delete getPrivatized(pid);
+    clearPrivatized(pid);
+    chpl_privatization_freePid(pid);
+  }
+}
+
+writeln("live: ", chpl_numPrivatizedClasses() - liveBefore);
+writeln("reused: ", chpl_numPrivatizedPidsReused() - reusedBefore);
+writeln("distinct pids bounded: ", maxPid < liveBefore + 2*numPerStep + 64);
+writeln("table grew: ", chpl_privatizedClassesCapacity() != capacity);
@@ -0,0 +1,49 @@
+use IO, List;
+
+config const numLines = 20000;
+
+// Lines long enough that some will straddle the channel's buffer parts
+var f = opentmp();
+{
+  var w = f.writer();
+  for i in 1..numLines do
+    w.writeln(i, ":", "y" * (i % 300));
+  w.write("last");
+  w.close();
+}
+
+proc check(hints) {
+  var count, sum: int;
+  var sawLast = false;
+  var r = f.reader(hints=hints);
+  for v in r.lineViews() {
+    if v == b"last" {
+      sawLast = true;
+    } else {
+      count += 1;
+      sum += v.partition(b":")(1).decode():int;
+      if v.byte(v.size) != 0x0a then writeln("missing newline: ", v);
+    }
+  }
+  r.close();
+  return count == numLines && sum == numLines*(numLines+1)/2 && sawLast;
+}
+
+writeln(check(IOHINT_NONE));
+writeln(check(QIO_METHOD_MMAP));
+
+// Other delimiters, and views copied out of the loop
+var g = opentmp();
+{
+  var w = g.writer();
+  w.write("a,bb,,ccc,");
+  w.close();
+}
+var fields: list(bytes);
+var r = g.reader();
+for v in r.lineViews(delimiter=",".toByte()) do
+  fields.append(createBytesWithNewBuffer(v));
+writeln(fields);
+
+f.close();
+g.close();
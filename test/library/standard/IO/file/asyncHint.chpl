@@ -0,0 +1,51 @@
+use IO;
+
+config const n = 300000;
+
+// Spans many iobufs, so read-ahead and write-behind both
+// keep several requests in flight
+var f = opentmp(hints=IOHINT_ASYNC);
+{
+  var w = f.writer(kind=iokind.little);
+  for i in 1..n do
+    w.write(i:int(64));
+  w.close();
+}
+
+writeln(f.length() == n*8);
+
+proc check(r, lo, hi) {
+  var x: int(64);
+  var ok = true;
+  for i in lo..hi {
+    r.read(x);
+    if x != i then ok = false;
+  }
+  // and nothing after
+  return ok && !r.read(x);
+}
+
+// The whole file, then a region in the middle
+{
+  var r = f.reader(kind=iokind.little, hints=IOHINT_ASYNC);
+  writeln(check(r, 1, n));
+  r.close();
+}
+{
+  const lo = n/3, hi = 2*n/3;
+  var r = f.reader(kind=iokind.little, hints=IOHINT_ASYNC, start=(lo-1)*8, end=hi*8);
+  writeln(check(r, lo, hi));
+  r.close();
+}
+
+// Seeking discards what was read ahead
+{
+  var r = f.reader(kind=iokind.little, locking=false, hints=IOHINT_ASYNC);
+  var x: int(64);
+  r.read(x);
+  r.seek(start=(n-10)*8);
+  writeln(check(r, n-9, n));
+  r.close();
+}
+
+f.close();
@@ -0,0 +1,49 @@
+use IO, FileSystem;
+
+config const numLines = 50000;
+config const filename = "parallelLines.tmp";
+
+// Lines of varying length, so chunk boundaries fall mid-line
+{
+  var w = open(filename, iomode.cw).writer();
+  for i in 1..numLines do
+    w.writeln(i, " ", "x" * (i % 17));
+  w.close();
+}
+
+const f = open(filename, iomode.r);
+
+var serialCount, serialSum: int;
+for line in f.lines() {
+  serialCount += 1;
+  serialSum += line.partition(" ")(1):int;
+}
+
+var count, sum: int;
+forall line in f.parallelLines() with (+ reduce count, + reduce sum) {
+  count += 1;
+  sum += line.partition(" ")(1):int;
+}
+
+writeln(serialCount == numLines && serialSum == numLines*(numLines+1)/2);
+writeln(count == serialCount && sum == serialSum);
+
+// A serial loop over parallelLines() yields the lines in order
+var inOrder = true, prev = 0;
+for line in f.parallelLines() {
+  const i = line.partition(" ")(1):int;
+  if i != prev + 1 then inOrder = false;
+  prev = i;
+}
+writeln(inOrder && prev == numLines);
+
+// A region that starts and ends mid-line
+const (lo, hi) = (100003:int(64), 400001:int(64));
+var regCount, parRegCount: int;
+for line in f.lines(start=lo, end=hi) do regCount += 1;
+forall line in f.parallelLines(start=lo, end=hi) with (+ reduce parRegCount) do
+  parRegCount += 1;
+writeln(regCount == parRegCount);
+
+f.close();
+remove(filename);
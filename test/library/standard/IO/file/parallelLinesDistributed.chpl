@@ -0,0 +1,34 @@
+use IO, FileSystem;
+
+config const numLines = 50000;
+config const filename = "parallelLinesDistributed.tmp";
+
+{
+  var w = open(filename, iomode.cw).writer();
+  for i in 1..numLines do
+    w.writeln(i, " ", "x" * (i % 17));
+  w.close();
+}
+
+const f = open(filename, iomode.r);
+
+// Each line is read exactly once, whichever locales read them
+var count, sum: int;
+forall line in f.parallelLines(distributed=true)
+    with (+ reduce count, + reduce sum) {
+  count += 1;
+  sum += line.partition(" ")(1):int;
+}
+writeln(count == numLines && sum == numLines*(numLines+1)/2);
+
+// A region that starts and ends mid-line
+const (lo, hi) = (100003:int(64), 400001:int(64));
+var regCount, distRegCount: int;
+for line in f.lines(start=lo, end=hi) do regCount += 1;
+forall line in f.parallelLines(start=lo, end=hi, distributed=true)
+    with (+ reduce distRegCount) do
+  distRegCount += 1;
+writeln(regCount == distRegCount);
+
+f.close();
+remove(filename);
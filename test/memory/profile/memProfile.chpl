@@ -0,0 +1,12 @@
+use CPtr;
+
+// Allocations this large are always sampled, so the profile is
+// deterministic apart from the byte counts.
+proc main() {
+  var A: [1..1000000] int = 1;
+
+  // leaked on purpose, so it shows up in the live profile
+  var p = c_malloc(uint(8), 4000000);
+
+  writeln(+ reduce A);
+}
@@ -0,0 +1,24 @@
+use CacheDiagnostics;
+
+config const n = 4096;
+
+on Locales[1] {
+  var A: [1..n] int = 1..n;
+  on Locales[0] {
+    resetCacheDiagnostics();
+    startCacheDiagnostics();
+    var sum = 0;
+    for i in 1..n do sum += A[i];
+    for i in 1..n do sum += A[i];
+    stopCacheDiagnostics();
+    writeln(sum == n*(n+1));
+    const d = getCacheDiagnostics()[0];
+    const t = getTaskCacheDiagnostics();
+    // the second pass over A should be served entirely by the cache
+    writeln(d.hits > d.misses);
+    writeln(d.prefetch_hits > 0 && d.readaheads > 0);
+    writeln(d.bytes_saved >= n * numBytes(int));
+    writeln(t.hits == d.hits && t.misses == d.misses);
+    writeln(getCacheDiagnostics()[1]);
+  }
+}
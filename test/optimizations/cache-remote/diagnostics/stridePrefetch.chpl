@@ -0,0 +1,21 @@
+// Reading a remote matrix by columns should be detected as a
+// constant-stride stream and prefetched for.
+use CacheDiagnostics;
+
+config const n = 256;
+
+on Locales[1] {
+  var A: [1..n, 1..n] int;
+  forall (i, j) in A.domain do A[i, j] = (i-1)*n + j;
+  on Locales[0] {
+    startCacheDiagnostics();
+    var sum = 0;
+    for j in 1..n do
+      for i in 1..n do
+        sum += A[i, j];
+    stopCacheDiagnostics();
+    writeln(sum == (n*n)*(n*n+1)/2);
+    const d = getCacheDiagnosticsHere();
+    writeln(d.stride_prefetches > 0 && d.prefetch_hits > 0);
+  }
+}
@@ -0,0 +1,69 @@
+//
+// Measures the bandwidth of bulk copies between two arrays on the same
+// locale, both for a contiguous whole-array copy and for a strided copy
+// of the interior columns.  Compare runs with --dataParTasksPerLocale=1
+// against the default to see how well the parallel copy scales.
+//
+
+use Memory, Time;
+
+config const memFraction = 100;
+config const numTrials = 5;
+config const printPerf = false;
+
+type elemType = int;
+
+// assume two arrays of the problem size fit in the target fraction
+const totalMem = here.physicalMemory(unit = MemUnits.Bytes);
+const target = (totalMem / numBytes(elemType)) / (2 * memFraction);
+
+config const cols = 1024;
+config const rows = max(min(target, 1e9:int) / cols, 2);
+
+const D = {1..rows, 1..cols};
+const Inner = {1..rows, 2..cols-1};
+
+var A, B: [D] elemType;
+
+forall (i, j) in D do
+  B[i, j] = (i-1)*cols + j;
+
+proc gbPerSec(numElems, secs) {
+  return (numElems * numBytes(elemType)):real / secs / 1e9;
+}
+
+var t: Timer;
+
+var contigTime = max(real);
+for 1..numTrials {
+  t.clear();
+  t.start();
+  A = B;
+  t.stop();
+  contigTime = min(contigTime, t.elapsed());
+}
+
+const contigOK = && reduce (A == B);
+
+A = 0;
+
+var stridedTime = max(real);
+for 1..numTrials {
+  t.clear();
+  t.start();
+  A[Inner] = B[Inner];
+  t.stop();
+  stridedTime = min(stridedTime, t.elapsed());
+}
+
+const stridedOK = && reduce [(i, j) in D] (if Inner.contains((i, j))
+                                           then A[i, j] == B[i, j]
+                                           else A[i, j] == 0);
+
+if printPerf {
+  writeln("Bytes per array = ", D.size * numBytes(elemType));
+  writeln("Contiguous copy bandwidth (GB/s) = ", gbPerSec(D.size, contigTime));
+  writeln("Strided copy bandwidth (GB/s) = ", gbPerSec(Inner.size, stridedTime));
+}
+
+writeln("Validation: ", if contigOK && stridedOK then "SUCCESS" else "FAILURE");
@@ -0,0 +1,90 @@
+//
+// Measures how fast the formatted reader and writer handle numeric
+// text: writing and reading back whitespace-separated ints and reals
+// with the default style, as in a MatrixMarket or CSV file.
+//
+
+use IO, Time;
+
+config const n = 1000000;
+config const printPerf = false;
+
+var A: [0..#n] int;
+var B: [0..#n] real;
+
+for i in 0..#n {
+  A[i] = (i * 7919) % 1000003 - 500000;
+  B[i] = A[i] / 1024.0;
+}
+
+proc mbPerSec(numBytes, secs: real) {
+  return numBytes:real / secs / 1e6;
+}
+
+var t: Timer;
+
+// ints
+const fi = openmem();
+t.start();
+{
+  var w = fi.writer();
+  for x in A do
+    w.writeln(x);
+  w.close();
+}
+t.stop();
+const intWriteTime = t.elapsed();
+t.clear();
+
+var intsOK = true;
+t.start();
+{
+  var r = fi.reader();
+  var x: int;
+  for i in 0..#n {
+    r.read(x);
+    if x != A[i] then intsOK = false;
+  }
+  r.close();
+}
+t.stop();
+const intReadTime = t.elapsed();
+t.clear();
+
+// reals
+const fr = openmem();
+t.start();
+{
+  var w = fr.writer();
+  for x in B do
+    w.writeln(x);
+  w.close();
+}
+t.stop();
+const realWriteTime = t.elapsed();
+t.clear();
+
+// Values are written with 6 significant digits, so compare
+// against what was written rather than against B.
+var realsOK = true;
+t.start();
+{
+  var r = fr.reader();
+  var x: real;
+  for i in 0..#n {
+    r.read(x);
+    if abs(x - B[i]) > 1e-5 * abs(B[i]) then realsOK = false;
+  }
+  r.close();
+}
+t.stop();
+const realReadTime = t.elapsed();
+
+if printPerf {
+  writeln("int write (MB/s) = ", mbPerSec(fi.length(), intWriteTime));
+  writeln("int read (MB/s) = ", mbPerSec(fi.length(), intReadTime));
+  writeln("real write (MB/s) = ", mbPerSec(fr.length(), realWriteTime));
+  writeln("real read (MB/s) = ", mbPerSec(fr.length(), realReadTime));
+}
+
+writeln("Validation: ", if intsOK && realsOK then "SUCCESS" else "FAILURE");
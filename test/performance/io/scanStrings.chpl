@@ -0,0 +1,120 @@
+//
+// Measures how fast the formatted reader scans text: whole lines with
+// readline(), whitespace-separated words with read(string), and
+// quoted strings with a %"S readf.  All three go through
+// qio_channel_scan_string().  The file is built from ASCII text with
+// a few escapes and multibyte characters mixed in, so the runs that
+// scan_string copies in bulk are interrupted now and then.
+//
+
+use IO, Time;
+
+config const numLines = 200000;
+config const wordsPerLine = 8;
+config const printPerf = false;
+
+const words = ["alpha", "beta", "gamma", "delta", "epsilon", "zeta",
+               "eta", "theta", "iota", "kappa", "lambda", "μ"];
+
+proc lineText(i: int) {
+  var s = "";
+  for j in 0..#wordsPerLine do
+    s += words[words.domain.low + (i + j) % words.size] + " ";
+  return s + i:string;
+}
+
+proc quotedText(i: int) {
+  return lineText(i) + " \"q\\" + i:string;
+}
+
+// Validation only compares lengths and counts, so that building the
+// expected strings stays out of the timed loops.
+var lineBytes, quotedBytes = 0;
+
+const f = openmem();
+{
+  var w = f.writer();
+  for i in 0..#numLines {
+    const line = lineText(i);
+    w.writeln(line);
+    lineBytes += line.numBytes + 1;
+  }
+  w.close();
+}
+
+const fileBytes = f.length();
+
+proc mbPerSec(secs: real) {
+  return fileBytes:real / secs / 1e6;
+}
+
+var t: Timer;
+
+// whole lines
+var numLines1, numLineBytes = 0;
+t.start();
+{
+  var r = f.reader();
+  var line: string;
+  while r.readline(line) {
+    numLines1 += 1;
+    numLineBytes += line.numBytes;
+  }
+  r.close();
+}
+t.stop();
+const lineTime = t.elapsed();
+t.clear();
+
+// whitespace-separated words
+var numWords = 0;
+t.start();
+{
+  var r = f.reader();
+  var word: string;
+  while r.read(word) do
+    numWords += 1;
+  r.close();
+}
+t.stop();
+const wordTime = t.elapsed();
+t.clear();
+
+// quoted strings, with escapes
+const q = openmem();
+{
+  var w = q.writer();
+  for i in 0..#numLines {
+    const s = quotedText(i);
+    w.writef("%\"S\n", s);
+    quotedBytes += s.numBytes;
+  }
+  w.close();
+}
+
+var numQuoted, numQuotedBytes = 0;
+t.start();
+{
+  var r = q.reader();
+  var s: string;
+  while r.readf("%\"S", s) {
+    numQuoted += 1;
+    numQuotedBytes += s.numBytes;
+  }
+  r.close();
+}
+t.stop();
+const quotedTime = t.elapsed();
+
+if printPerf {
+  writeln("Bytes = ", fileBytes);
+  writeln("readline (MB/s) = ", mbPerSec(lineTime));
+  writeln("read word (MB/s) = ", mbPerSec(wordTime));
+  writeln("readf quoted (MB/s) = ", q.length():real / quotedTime / 1e6);
+}
+
+const ok = numLines1 == numLines && numLineBytes == lineBytes &&
+           numWords == (wordsPerLine + 1) * numLines &&
+           numQuoted == numLines && numQuotedBytes == quotedBytes;
+
+writeln("Validation: ", if ok then "SUCCESS" else "FAILURE");
@@ -0,0 +1,39 @@
+// Exercise the fifo tasking layer's work-stealing scheduler: tasks
+// spawned from other tasks, nested cobegins that may be run by either
+// their owner or a thief, and coforall tasks that must all be running
+// at once to get past a barrier.
+
+config const n = 1000, width = 16, depth = 20;
+
+proc fib(k: int): int {
+  if k < 2 then return k;
+  var a, b: int;
+  if k > depth - 8 {
+    cobegin with (ref a, ref b) {
+      a = fib(k-1);
+      b = fib(k-2);
+    }
+  } else {
+    a = fib(k-1);
+    b = fib(k-2);
+  }
+  return a + b;
+}
+
+var count: atomic int;
+sync {
+  for 1..n do begin {
+    begin count.add(1);
+    count.add(1);
+  }
+}
+writeln(count.read());
+
+writeln(fib(depth));
+
+var arrived: atomic int;
+coforall 1..width {
+  arrived.add(1);
+  arrived.waitFor(width);
+}
+writeln(arrived.read());